@@ -14,421 +14,3226 @@
 #include <string> // Allows the use of pre-made string functions such as "getline"
 #include <vector> // Allows the use of vectors and their pre-made functions
 #include <iomanip> // Allows some formatting options such as setw for display
+#include <algorithm> // Allows the use of max for comparing subtree heights
+#include <unordered_set> // Allows course numbers to be interned so each is copied into a tree only once
+#include <string_view> // Allows fields to be read from the input file without copying them
+#include <cstring> // Allows the use of memchr for finding line endings and memcpy for copying strings into the arena
+#include <cstdint> // Allows the use of uintptr_t for aligning arena allocations
+#include <new> // Allows nodes to be constructed in memory handed out by the arena
+#include <type_traits> // Allows checking that arena-allocated types never need their destructors run
+#include <memory> // Allows cached prerequisite closures to be shared safely between callers
+#include <mutex> // Allows the prerequisite closure cache to be used from more than one thread
+#include <unordered_map> // Allows prerequisite closures to be cached by course ID
+#include <thread> // Allows large files to be parsed, validated, and sorted by several threads at once
+#include <chrono> // Allows benchmarks and operation metrics to be timed with a monotonic wall clock
+#include <atomic> // Allows operation metrics to be recorded from any thread without locking
+#include <random> // Allows benchmarks to generate the same synthetic catalogs and queries on every run
+#include <cstdio> // Allows the use of snprintf for formatting synthetic course numbers and remove for deleting generated catalogs
+#include <cstdlib> // Allows the use of atoi and atoll for reading benchmark options
+
+#if defined(_WIN32) // Windows has no mmap, so the whole file is read into memory instead
+#include <intrin.h> // Allows the use of _BitScanForward for the delimiter scan
+#else
+#include <sys/mman.h> // Allows the input file to be memory-mapped
+#include <sys/stat.h> // Allows the size of the input file to be found before mapping it
+#include <fcntl.h> // Allows the input file to be opened for mapping
+#include <unistd.h> // Allows the file descriptor to be closed once the file is mapped
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h> // Allows 16 characters at a time to be checked for ',' and '\n'
+#endif
+#if defined(__AVX2__)
+#include <immintrin.h> // Allows four packed course numbers to be compared at a time
+#endif
 
 using namespace std; // Prevents the need for extraneous declarations (i.e., "std::") before many functions
 
-struct CourseObject { // Defining what a CourseObject holds
-    string courseNumber;
-    string name;
-    vector<string> prerequisites;
+struct PrerequisiteList { // Defining a read-only list of prerequisite course numbers stored alongside the course
+    const string_view* items = nullptr;
+    size_t count = 0;
+
+    const string_view* begin() const { return items; }
+    const string_view* end() const { return items + count; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+};
+
+struct CourseObject { // Defining what a CourseObject holds (the text is owned by the BinarySearchTree's arena once inserted)
+    string_view courseNumber;
+    string_view name;
+    PrerequisiteList prerequisites;
+};
+
+const size_t PACKED_KEY_LENGTH = 8; // Characters of a course number that fit in a packed 64-bit key
+
+struct CourseKey { // Defining a course number packed into an integer, so most comparisons are a single integer comparison
+    uint64_t packed; // The first PACKED_KEY_LENGTH characters, upper-cased and zero-padded, with the first character in the most significant byte
+    string_view text; // The full course number, only read when two keys are too long to be told apart by their packed characters
 };
 
+char foldCharacter(char c) { // Upper-cases a letter so searches ignore case (e.g., "csci300" finds "CSCI300")
+    return (c >= 'a' && c <= 'z') ? static_cast<char>(c - 'a' + 'A') : c;
+}
+
+CourseKey makeCourseKey(string_view courseNumber) { // Packs and upper-cases a course number once, so comparisons never need to fold case again
+    uint64_t packed = 0;
+    size_t length = min(courseNumber.size(), PACKED_KEY_LENGTH);
+    for (size_t i = 0; i < length; ++i) {
+        packed |= static_cast<uint64_t>(static_cast<unsigned char>(foldCharacter(courseNumber[i]))) << (56 - 8 * i);
+    }
+    return { packed, courseNumber };
+}
+
+bool hasCoursePrefix(string_view courseNumber, string_view prefix) { // Checks if a course number starts with prefix, ignoring case (e.g., "math" matches "MATH201")
+    if (courseNumber.size() < prefix.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < prefix.size(); ++i) {
+        if (foldCharacter(courseNumber[i]) != foldCharacter(prefix[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int compareCourseKeys(const CourseKey& first, const CourseKey& second) { // Returns a negative number, zero, or a positive number when first sorts before, the same as, or after second
+    if (first.packed != second.packed) {
+        return first.packed < second.packed ? -1 : 1;
+    }
+    if (first.text.size() <= PACKED_KEY_LENGTH && second.text.size() <= PACKED_KEY_LENGTH) { // Both course numbers fit in their packed keys, so they are equal
+        return 0;
+    }
+    for (size_t i = PACKED_KEY_LENGTH; i < first.text.size() && i < second.text.size(); ++i) { // Fall back to comparing the characters that did not fit
+        unsigned char firstCharacter = static_cast<unsigned char>(foldCharacter(first.text[i]));
+        unsigned char secondCharacter = static_cast<unsigned char>(foldCharacter(second.text[i]));
+        if (firstCharacter != secondCharacter) {
+            return firstCharacter < secondCharacter ? -1 : 1;
+        }
+    }
+    if (first.text.size() == second.text.size()) {
+        return 0;
+    }
+    return first.text.size() < second.text.size() ? -1 : 1; // A course number sorts before any longer course number that starts with it
+}
+
 struct BSTNode { // Defining the internal structure for BinarySearchTree node
     CourseObject courseObject;
+    uint64_t packedKey; // The courseObject's packed course number, kept in the node so most comparisons never touch the text
     BSTNode* left;
     BSTNode* right;
+    int height; // Height of the subtree rooted at this node, used to keep the BinarySearchTree balanced
+    int size; // Number of nodes in the subtree rooted at this node, used for counting and order-statistic queries
 
     BSTNode() { // Default constructor
+        packedKey = 0;
         left = nullptr;
         right = nullptr;
+        height = 1;
+        size = 1;
+    }
+
+    BSTNode(CourseObject&& aCourseObject) : BSTNode() { // Initialize a BSTNode by moving in a courseObject
+        courseObject = move(aCourseObject);
+        packedKey = makeCourseKey(courseObject.courseNumber).packed;
+    }
+
+    CourseKey key() const { // Returns the CourseKey for this node's course number without packing it again
+        return { packedKey, courseObject.courseNumber };
+    }
+};
+
+static_assert(is_trivially_destructible<BSTNode>::value, "BSTNode is freed by resetting the arena, so it must not need a destructor");
+
+const int MAX_TREE_HEIGHT = 64; // A balanced tree this tall would need more nodes than memory can hold, so fixed-size traversal stacks never overflow
+
+class TreeCursor { // Defining a position in the in-order walk of a BinarySearchTree, so any run of courses can be read without walking the rest of the tree
+private:
+    BSTNode* stack[MAX_TREE_HEIGHT]; // The next node to visit is on top, with the ancestors still to be visited beneath it
+    int stackSize;
+    void pushLeftEdge(BSTNode* node);
+    void pushPosition(BSTNode* node, int index);
+    friend class BinarySearchTree; // The tree positions new cursors
+
+public:
+    TreeCursor();
+    const CourseObject* Peek() const;
+    const CourseObject* Next();
+    void Skip(int count);
+    bool AtEnd() const;
+};
+
+class MappedFile { // Defining a read-only view of an entire input file, memory-mapped where the platform allows it
+private:
+    const char* data;
+    size_t size;
+#if defined(_WIN32)
+    vector<char> buffer; // Holds the file contents on platforms without mmap
+#endif
+
+public:
+    MappedFile();
+    virtual ~MappedFile();
+    MappedFile(const MappedFile&) = delete; // A mapping is released exactly once, so it may not be copied
+    MappedFile& operator=(const MappedFile&) = delete;
+    bool Open(const string& filePath);
+    void AdviseRandomAccess();
+    void Close();
+    string_view Contents() const;
+};
+
+const size_t ARENA_BLOCK_SIZE = 256 * 1024; // Size of each block the arena requests from the system
+
+class CatalogArena { // Defining a bump allocator that hands out memory from large blocks and frees all of it in a single reset
+private:
+    vector<char*> blocks; // Every block requested so far, released together by Reset
+    char* current; // The next free byte in the newest block
+    size_t remaining; // Bytes left in the newest block
+    size_t reservedBytes; // Bytes in every block, reported to the operation metrics when they are released
+
+public:
+    CatalogArena();
+    virtual ~CatalogArena();
+    CatalogArena(const CatalogArena&) = delete; // Blocks are released exactly once, so an arena may not be copied
+    CatalogArena& operator=(const CatalogArena&) = delete;
+    void* Allocate(size_t bytes, size_t alignment);
+    void Reset();
+    size_t ReservedBytes() const;
+};
+
+const size_t COMPACTION_RATIO = 2; // A tree changed by delta files is copied into an arena of its own once the arenas it keeps alive hold this many times the bytes of its last full build
+
+class BinarySearchTree { // Defining the functions and variables of a self-balancing (AVL) BinarySearchTree to be used in this program
+private:
+    BSTNode* root;
+    shared_ptr<CatalogArena> arena; // Owns every node and string the tree created, shared with any newer tree made from this one by ShareNodes
+    vector<shared_ptr<const CatalogArena>> sharedArenas; // The arenas of older trees whose nodes and text this tree still uses, oldest first
+    size_t builtBytes; // Bytes the arena held right after the tree was last built in full, which estimates what its live courses need
+    BSTNode* addNode(BSTNode* node, CourseObject&& courseObject);
+    BSTNode* allocateNode(CourseObject&& courseObject);
+    BSTNode* copyNode(const BSTNode* node);
+    string_view storeString(string_view text);
+    string_view internString(string_view text, unordered_set<string_view>& internTable);
+    void storeCourseObject(CourseObject& courseObject, unordered_set<string_view>& internTable);
+    BSTNode* findNode(string_view courseNumber) const;
+    void destroyTree();
+    BSTNode* removeNode(BSTNode* node, string_view courseNumber);
+    static int height(BSTNode* node);
+    static int subtreeSize(BSTNode* node);
+    static void updateNode(BSTNode* node);
+    static BSTNode* rotateLeft(BSTNode* node);
+    static BSTNode* rotateRight(BSTNode* node);
+    BSTNode* rebalance(BSTNode* node);
+    BSTNode* retrace(BSTNode* path[], bool wentLeft[], int depth, BSTNode* child);
+    static BSTNode* linkBalanced(BSTNode* nodes, size_t first, size_t last);
+    TreeCursor seek(string_view courseNumber, bool pastEqual) const;
+
+public:
+    BinarySearchTree();
+    virtual ~BinarySearchTree();
+    int Size() const;
+    int Height() const;
+    int Rank(string_view courseNumber) const;
+    int CountBelow(string_view courseNumber, bool includeEqual) const;
+    int CountBetween(string_view lowCourseNumber, string_view highCourseNumber) const;
+    const CourseObject* Select(int index) const;
+    TreeCursor CursorAt(int index) const;
+    TreeCursor LowerBound(string_view courseNumber) const;
+    TreeCursor UpperBound(string_view courseNumber) const;
+    template <typename Visitor> void ForEachInRange(string_view lowCourseNumber, string_view highCourseNumber, Visitor visit) const;
+    template <typename Visitor> void ForEachWithPrefix(string_view prefix, Visitor visit) const;
+    template <typename Visitor> void ForEachInOrder(Visitor visit) const;
+    void Insert(CourseObject&& courseObject);
+    void BuildFromSorted(vector<CourseObject>& sortedCourses, bool copyText);
+    void ShareNodes(const BinarySearchTree& other);
+    size_t RetainedBytes() const;
+    bool NeedsCompaction() const;
+    void Compact(const vector<int>& firstPrerequisites, const vector<int>& prerequisiteIds);
+    void Remove(string_view courseNumber);
+    const CourseObject* Search(string_view courseNumber) const;
+    void MergeJoin(const CourseKey* sortedKeys, size_t count, const CourseObject** results) const;
+};
+
+const size_t CACHE_LINE_SIZE = 64; // Size in bytes of a cache line on the processors this program targets
+
+template <typename T>
+struct CacheLineAllocator { // Defining an allocator that starts every array on a cache line boundary
+    using value_type = T;
+
+    CacheLineAllocator() = default;
+    template <typename U> CacheLineAllocator(const CacheLineAllocator<U>&) {}
+
+    T* allocate(size_t count) {
+        return static_cast<T*>(::operator new(count * sizeof(T), align_val_t(CACHE_LINE_SIZE)));
+    }
+
+    void deallocate(T* items, size_t) {
+        ::operator delete(items, align_val_t(CACHE_LINE_SIZE));
+    }
+};
+
+template <typename T, typename U>
+bool operator==(const CacheLineAllocator<T>&, const CacheLineAllocator<U>&) { return true; } // Any two allocators can free each other's memory
+
+template <typename T, typename U>
+bool operator!=(const CacheLineAllocator<T>&, const CacheLineAllocator<U>&) { return false; }
+
+struct IndexEntry { // Defining what a CatalogIndex search finds: a course and its alphanumeric position, which is also its ID
+    const CourseObject* course;
+    int id;
+};
+
+class CatalogIndex { // Defining a read-only copy of a loaded BinarySearchTree's keys laid out in Eytzinger (breadth-first) order for cache-friendly, branchless lookups
+private:
+    vector<uint64_t, CacheLineAllocator<uint64_t>> keys; // Packed course numbers in Eytzinger order starting at position 1, so the children of position k are 2k and 2k + 1
+    vector<IndexEntry> entries; // The course and ID for each Eytzinger position, kept apart from the keys so searches only touch keys
+    vector<const CourseObject*> courses; // The courses in alphanumeric order, so a course's position is also its ID
+    int completeLevels; // Number of levels of the implicit tree that are completely filled
+    size_t descend(uint64_t packed, size_t position) const;
+    IndexEntry resolve(const CourseKey& key, size_t position) const;
+
+public:
+    CatalogIndex();
+    void Build(const BinarySearchTree& tree);
+    void Export(vector<uint64_t>& eytzingerKeys, vector<int32_t>& eytzingerIds) const;
+    bool Import(const uint64_t* eytzingerKeys, const int32_t* eytzingerIds, const BinarySearchTree& tree);
+    void Clear();
+    int Size() const;
+    size_t MemoryBytes() const;
+    const CourseObject* Find(string_view courseNumber) const;
+    int FindId(string_view courseNumber) const;
+    const CourseObject* CourseAt(int id) const;
+    void FindBatch(const string_view* courseNumbers, size_t count, const CourseObject** results) const;
+};
+
+const size_t CLOSURE_CACHE_LIMIT = 4096; // Most transitive closures kept at once, as each one holds a bit for every course
+
+class PrerequisiteGraph { // Defining a directed graph of the loaded courses' prerequisites, using each course's alphanumeric position in a CatalogIndex as a compact integer ID
+private:
+    const CatalogIndex* index; // Maps course numbers to IDs and IDs back to courses
+    vector<int> prerequisiteStart; // The direct prerequisites of course id are prerequisiteIds[prerequisiteStart[id]] up to prerequisiteIds[prerequisiteStart[id + 1]]
+    vector<int> prerequisiteIds;
+    vector<int> dependentStart; // The courses that directly require course id are dependentIds[dependentStart[id]] up to dependentIds[dependentStart[id + 1]]
+    vector<int> dependentIds;
+    vector<int> semesters; // The earliest semester each course can be taken, where courses without prerequisites are in semester 1
+    mutable mutex closureMutex; // Guards closureCache, as queries may come from more than one thread
+    mutable unordered_map<int, shared_ptr<const vector<uint64_t>>> closureCache; // Transitive prerequisites already computed, one bit per course ID
+    static void markReachable(vector<uint64_t>& bits, int id, const vector<int>& start, const vector<int>& ids);
+    vector<int> reachable(int id, const vector<int>& start, const vector<int>& ids) const;
+    static vector<int> bitsToIds(const vector<uint64_t>& bits);
+    bool linkDependents(vector<int>& cycle);
+
+public:
+    PrerequisiteGraph();
+    bool Build(const CatalogIndex& catalogIndex, vector<int>& cycle);
+    bool Import(const CatalogIndex& catalogIndex, vector<int>&& firstPrerequisites, vector<int>&& prerequisiteList, vector<int>& cycle);
+    int PrerequisiteId(int id, int i) const;
+    int PrerequisiteCount(int id) const;
+    void Clear();
+    int Size() const;
+    size_t MemoryBytes() const;
+    int Id(string_view courseNumber) const;
+    const CourseObject* Course(int id) const;
+    shared_ptr<const vector<uint64_t>> Closure(int id) const;
+    vector<int> AllPrerequisites(int id) const;
+    vector<int> Dependents(int id, bool transitive) const;
+    vector<vector<int>> SemesterPlan(int id) const;
+};
+
+enum MetricOperation { // The operations whose latencies are recorded
+    METRIC_LOAD, // Loading a whole file, from opening it to publishing the catalog
+    METRIC_PARSE, // Splitting and parsing the lines of a file
+    METRIC_VALIDATE, // Sorting the parsed courses and checking them for duplicates and missing prerequisites
+    METRIC_INSERT, // Building the tree from the validated courses
+    METRIC_SEARCH, // Finding one course by its course number
+    METRIC_TRAVERSE, // Displaying every course in order
+    METRIC_RANGE, // Listing the courses matching a prefix or range, or one page of the listing
+    METRIC_BATCH, // Finding a whole list of courses in one call, timed once for the list
+    METRIC_APPLY, // Applying a delta file, from opening it to publishing the changed catalog
+    METRIC_OPERATION_COUNT
+};
+
+const char* METRIC_OPERATION_NAMES[METRIC_OPERATION_COUNT] = { "load", "parse", "validate", "insert", "search", "traverse", "range", "batch", "apply" };
+const int LATENCY_BUCKETS = 64; // Bucket i counts latencies of at least 2^(i - 1) and under 2^i nanoseconds
+const int SEARCH_SAMPLE_INTERVAL = 16; // Only every 16th search on each thread is timed, as reading the clock twice costs about as much as a search
+
+class LatencyHistogram { // Defining a histogram of latencies in power-of-two buckets, written by one thread and readable from any thread without locking
+private:
+    atomic<uint64_t> buckets[LATENCY_BUCKETS];
+    atomic<uint64_t> count;
+    atomic<uint64_t> totalNanoseconds;
+    atomic<uint64_t> maximumNanoseconds;
+    uint64_t percentile(double fraction) const;
+
+public:
+    LatencyHistogram();
+    void Record(uint64_t nanoseconds);
+    void Merge(const LatencyHistogram& other);
+    void WriteJson(ostream& out, int sampleInterval) const;
+};
+
+struct MetricShard { // Defining one thread's share of the operation metrics, which only that thread writes, so recording never contends with other threads
+    LatencyHistogram latencies[METRIC_OPERATION_COUNT];
+    atomic<uint64_t> comparisonCounts[MAX_TREE_HEIGHT + 1]; // Number of searches that compared the search key with each possible number of keys
+    int searchesUntilSample; // Searches left before the next one is timed, only ever read by the owning thread
+
+    MetricShard();
+};
+
+class MetricShardLease { // Defining a thread's claim on a MetricShard, handed back for reuse when the thread exits
+public:
+    MetricShard* shard = nullptr;
+    ~MetricShardLease();
+};
+
+class OperationMetrics { // Defining the always-on counters for every operation, safe to update from any thread
+private:
+    mutable mutex shardMutex; // Guards the lists of shards, which only change when a thread records its first metric or exits
+    vector<unique_ptr<MetricShard>> shards; // Every shard handed out so far, all merged when the metrics are written
+    vector<MetricShard*> idleShards; // Shards of threads that have exited, reused so there are only as many shards as threads ever alive at once
+    atomic<uint64_t> systemAllocations; // Blocks requested from the system by every arena
+    atomic<uint64_t> bytesAllocated;
+    atomic<uint64_t> bytesReleased;
+    MetricShard& localShard();
+    friend class MetricShardLease; // Hands exited threads' shards back
+
+public:
+    OperationMetrics();
+    bool ShouldTime(MetricOperation operation);
+    void RecordLatency(MetricOperation operation, uint64_t nanoseconds);
+    void RecordComparisons(int comparisons);
+    void RecordAllocation(size_t bytes);
+    void RecordRelease(size_t bytes);
+    void WriteJson(ostream& out, size_t catalogBytes) const;
+};
+
+class ScopedLatency { // Defining a timer that records the latency of an operation when it goes out of scope
+private:
+    MetricOperation operation;
+    chrono::steady_clock::time_point start;
+    bool stopped; // Set once the latency has been recorded
+
+public:
+    explicit ScopedLatency(MetricOperation timedOperation);
+    ~ScopedLatency();
+    void Stop();
+    ScopedLatency(const ScopedLatency&) = delete; // Each operation is recorded exactly once
+    ScopedLatency& operator=(const ScopedLatency&) = delete;
+};
+
+const size_t COURSE_NUMBER_COLUMN_WIDTH = 10; // Widths of the course listing's columns
+const size_t NAME_COLUMN_WIDTH = 35;
+const size_t PREREQUISITE_COLUMN_WIDTH = 14;
+const size_t LISTING_BUFFER_SIZE = 256 * 1024; // Course listings are written in pieces of about this many bytes
+
+class ListingBuffer { // Defining a course listing that is formatted into one large buffer and written out in large pieces, instead of one flushed line at a time
+private:
+    ostream& out;
+    string& buffer; // This thread's reusable buffer, so listings do not allocate once it has grown
+
+public:
+    explicit ListingBuffer(ostream& output);
+    virtual ~ListingBuffer();
+    ListingBuffer(const ListingBuffer&) = delete; // Only one listing may use a thread's buffer at a time
+    ListingBuffer& operator=(const ListingBuffer&) = delete;
+    void Append(string_view text);
+    void AppendCourse(const CourseObject& courseObject);
+    void Flush();
+};
+
+struct MappedSource { // Defining a mapped input file and, for a snapshot, the prerequisite lists that view its text
+    MappedFile file;
+    vector<string_view> snapshotPrerequisites; // The prerequisites of every course loaded from a snapshot, viewing course numbers in file
+};
+
+struct Catalog { // Defining everything loaded from one file, which is never changed once it has been published
+    shared_ptr<const MappedSource> snapshot; // For a catalog loaded from a snapshot, and every catalog made from it by delta files until one compacts its tree, the snapshot whose text the courses view in place
+    BinarySearchTree tree; // Holds all course objects, sharing the unchanged ones with the catalog a delta file was applied to
+    string fileHeader; // Stores the first line of the file as a header to be used while printing but not stored in the BinarySearchTree
+    string headerRow; // The header already formatted as a row of the course listing, so it is only split once
+    CatalogIndex index; // A frozen copy of the BinarySearchTree's keys used to answer searches
+    PrerequisiteGraph graph; // The prerequisites of the loaded courses, used to answer planning questions
+};
+
+//============================================================================
+// Global variables accessible by all functions
+//============================================================================
+shared_ptr<const Catalog> liveCatalog; // The published catalog, only read or replaced through currentCatalog() and publishCatalog()
+thread_local int nodesSearched; // Keep track of amount of nodes searched by this thread's last search
+OperationMetrics metrics; // Latencies, search comparisons, and memory use of every operation since the program started
+mutex catalogUpdateMutex; // Held while the published catalog is replaced, so a delta file is never applied to a catalog that is being replaced
+thread_local string listingStorage; // The buffer every course listing on this thread formats its rows into
+
+shared_ptr<const Catalog> currentCatalog() { // Returns a snapshot of the published catalog, which stays valid for as long as the caller holds it, even if a new catalog is published
+    return atomic_load(&liveCatalog);
+}
+
+void publishCatalog(shared_ptr<const Catalog> catalog) { // Replaces the published catalog, the old one being freed once its last reader lets go of it
+    atomic_store(&liveCatalog, move(catalog));
+}
+
+void appendPadded(string& row, string_view text, size_t width) { // Appends text to a row, followed by enough spaces to fill its column (text wider than its column is not cut)
+    row.append(text.data(), text.size());
+    if (text.size() < width) {
+        row.append(width - text.size(), ' ');
+    }
+}
+
+void appendCourseRow(string& rows, const CourseObject& courseObject) { // Formats a CourseObject as one row of the course listing
+    appendPadded(rows, courseObject.courseNumber, COURSE_NUMBER_COLUMN_WIDTH);
+    rows += '|';
+    appendPadded(rows, courseObject.name, NAME_COLUMN_WIDTH);
+    rows += '|';
+    if (!courseObject.prerequisites.empty()) { // Formats any prerequisites held by the CourseObject
+        bool firstPrerequisite = true;
+        for (string_view prerequisite : courseObject.prerequisites) {
+            if (!firstPrerequisite) {
+                rows += '|';
+            }
+            appendPadded(rows, prerequisite, PREREQUISITE_COLUMN_WIDTH);
+            firstPrerequisite = false;
+        }
+    }
+    else {
+        appendPadded(rows, "None", PREREQUISITE_COLUMN_WIDTH);
+    }
+    rows += '\n';
+}
+
+ListingBuffer::ListingBuffer(ostream& output) : out(output), buffer(listingStorage) { // Starts a listing that writes to output, reusing this thread's buffer (Public)
+    buffer.clear();
+    buffer.reserve(LISTING_BUFFER_SIZE + LISTING_BUFFER_SIZE / 4); // Room for the row that crosses the flush threshold
+}
+
+ListingBuffer::~ListingBuffer() { // Writes whatever is still buffered (Public)
+    Flush();
+}
+
+void ListingBuffer::Append(string_view text) { // Adds already formatted text to the listing (Public)
+    buffer.append(text.data(), text.size());
+    if (buffer.size() >= LISTING_BUFFER_SIZE) {
+        Flush();
+    }
+}
+
+void ListingBuffer::AppendCourse(const CourseObject& courseObject) { // Adds one course's row to the listing (Public)
+    appendCourseRow(buffer, courseObject);
+    if (buffer.size() >= LISTING_BUFFER_SIZE) {
+        Flush();
+    }
+}
+
+void ListingBuffer::Flush() { // Writes the buffered rows in one call and empties the buffer, keeping its memory (Public)
+    if (!buffer.empty()) {
+        out.write(buffer.data(), static_cast<streamsize>(buffer.size()));
+        buffer.clear();
+    }
+    out.flush();
+}
+
+CatalogArena::CatalogArena() { // Default constructor for an empty CatalogArena (Public)
+    current = nullptr;
+    remaining = 0;
+    reservedBytes = 0;
+}
+
+CatalogArena::~CatalogArena() { // Destructor for a CatalogArena releases every block (Public)
+    Reset();
+}
+
+void* CatalogArena::Allocate(size_t bytes, size_t alignment) { // Returns memory for bytes at the requested alignment, valid until the next Reset (Public)
+    if (bytes > ARENA_BLOCK_SIZE / 4) { // Large requests get a block of their own so the current block is not wasted
+        char* block = static_cast<char*>(::operator new(bytes));
+        blocks.push_back(block);
+        reservedBytes += bytes;
+        metrics.RecordAllocation(bytes);
+        return block;
+    }
+    size_t padding = current == nullptr ? 0 : (alignment - reinterpret_cast<uintptr_t>(current) % alignment) % alignment;
+    if (current == nullptr || padding + bytes > remaining) { // Start a new block when the current one is full
+        current = static_cast<char*>(::operator new(ARENA_BLOCK_SIZE)); // Blocks from operator new are aligned for any type
+        blocks.push_back(current);
+        remaining = ARENA_BLOCK_SIZE;
+        reservedBytes += ARENA_BLOCK_SIZE;
+        metrics.RecordAllocation(ARENA_BLOCK_SIZE);
+        padding = 0;
+    }
+    char* result = current + padding;
+    current = result + bytes;
+    remaining -= padding + bytes;
+    return result;
+}
+
+size_t CatalogArena::ReservedBytes() const { // Returns the bytes in every block the arena holds (Public)
+    return reservedBytes;
+}
+
+void CatalogArena::Reset() { // Frees everything the arena has handed out at once (Public)
+    for (char* block : blocks) {
+        ::operator delete(block);
+    }
+    blocks.clear();
+    current = nullptr;
+    remaining = 0;
+    metrics.RecordRelease(reservedBytes);
+    reservedBytes = 0;
+}
+
+BinarySearchTree::BinarySearchTree() { // Default constructor for a BinarySearchTree (Public)
+    root = nullptr; // Initialize the root of the BinarySearchTree as nullptr
+    arena = make_shared<CatalogArena>();
+    builtBytes = 0;
+}
+
+BinarySearchTree::~BinarySearchTree() { // Destructor for a BinarySearchTree used when delete is called, where each arena is freed with a single reset by the last tree using it (Public)
+    root = nullptr;
+}
+
+int BinarySearchTree::Size() const { // Returns the size of a BinarySearchTree, which the root keeps up to date (Public)
+    return subtreeSize(root);
+}
+
+int BinarySearchTree::Height() const { // Returns the number of levels in the BinarySearchTree, which the root keeps up to date (Public)
+    return height(root);
+}
+
+int BinarySearchTree::Rank(string_view courseNumber) const { // Returns how many courses sort before the passed in courseNumber, which is its position when it is in the tree (Public)
+    return CountBelow(courseNumber, false);
+}
+
+int BinarySearchTree::CountBelow(string_view courseNumber, bool includeEqual) const { // Counts the courses that sort before the passed in courseNumber, also counting an equal course if includeEqual is true (Public)
+    CourseKey key = makeCourseKey(courseNumber);
+    BSTNode* currentNode = root;
+    int count = 0;
+    while (currentNode != nullptr) {
+        int comparison = compareCourseKeys(key, currentNode->key());
+        bool goLeft = includeEqual ? comparison < 0 : comparison <= 0;
+        if (goLeft) {
+            currentNode = currentNode->left;
+        }
+        else { // The current node and its whole left subtree sort before the courseNumber
+            count += subtreeSize(currentNode->left) + 1;
+            currentNode = currentNode->right;
+        }
+    }
+    return count;
+}
+
+int BinarySearchTree::CountBetween(string_view lowCourseNumber, string_view highCourseNumber) const { // Counts the courses from lowCourseNumber through highCourseNumber, inclusive (Public)
+    if (compareCourseKeys(makeCourseKey(highCourseNumber), makeCourseKey(lowCourseNumber)) < 0) {
+        return 0;
+    }
+    return CountBelow(highCourseNumber, true) - CountBelow(lowCourseNumber, false);
+}
+
+const CourseObject* BinarySearchTree::Select(int index) const { // Returns the courseObject at the passed in position of the alphanumeric order (starting at 0), or nullptr if there is none (Public)
+    BSTNode* currentNode = root;
+    while (currentNode != nullptr) {
+        int leftSize = subtreeSize(currentNode->left);
+        if (index < leftSize) { // The position is inside the left subtree
+            currentNode = currentNode->left;
+        }
+        else if (index == leftSize) {
+            return &currentNode->courseObject;
+        }
+        else { // Skip the left subtree and the current node, and look for the rest of the position on the right
+            index -= leftSize + 1;
+            currentNode = currentNode->right;
+        }
+    }
+    return nullptr;
+}
+
+TreeCursor BinarySearchTree::CursorAt(int index) const { // Returns a cursor whose first course is at the passed in position of the alphanumeric order, found in O(log n) from the subtree sizes (Public)
+    TreeCursor cursor;
+    cursor.pushPosition(root, index);
+    return cursor; // A position past the end leaves the cursor empty
+}
+
+TreeCursor BinarySearchTree::seek(string_view courseNumber, bool pastEqual) const { // Returns a cursor whose first course is the first one not before courseNumber, or after it if pastEqual is true
+    CourseKey key = makeCourseKey(courseNumber);
+    TreeCursor cursor;
+    BSTNode* currentNode = root;
+    while (currentNode != nullptr) {
+        int comparison = compareCourseKeys(currentNode->key(), key);
+        if (pastEqual ? comparison > 0 : comparison >= 0) { // The current node is a candidate, and anything smaller that still qualifies is on its left
+            cursor.stack[cursor.stackSize++] = currentNode;
+            currentNode = currentNode->left;
+        }
+        else { // The current node and its left subtree come too early, so they are never visited
+            currentNode = currentNode->right;
+        }
+    }
+    return cursor;
+}
+
+TreeCursor BinarySearchTree::LowerBound(string_view courseNumber) const { // Returns a cursor starting at the first course that does not sort before courseNumber, in O(log n) (Public)
+    return seek(courseNumber, false);
+}
+
+TreeCursor BinarySearchTree::UpperBound(string_view courseNumber) const { // Returns a cursor starting at the first course that sorts after courseNumber, in O(log n) (Public)
+    return seek(courseNumber, true);
+}
+
+template <typename Visitor>
+void BinarySearchTree::ForEachInRange(string_view lowCourseNumber, string_view highCourseNumber, Visitor visit) const { // Passes each courseObject from lowCourseNumber through highCourseNumber, inclusive, to visit in order, in O(log n + k) (Public)
+    if (compareCourseKeys(makeCourseKey(highCourseNumber), makeCourseKey(lowCourseNumber)) < 0) { // An empty range, whose upper bound would come before its lower bound
+        return;
+    }
+    TreeCursor cursor = LowerBound(lowCourseNumber);
+    const CourseObject* end = UpperBound(highCourseNumber).Peek(); // The first course past the range, or nullptr if the range runs to the last course
+    while (cursor.Peek() != end) {
+        visit(*cursor.Next());
+    }
+}
+
+template <typename Visitor>
+void BinarySearchTree::ForEachWithPrefix(string_view prefix, Visitor visit) const { // Passes each courseObject whose course number starts with prefix, ignoring case, to visit in order, in O(log n + k) (Public)
+    TreeCursor cursor = LowerBound(prefix); // Course numbers starting with prefix sort together, right after everything sorting before prefix
+    while (!cursor.AtEnd() && hasCoursePrefix(cursor.Peek()->courseNumber, prefix)) {
+        visit(*cursor.Next());
+    }
+}
+
+TreeCursor::TreeCursor() { // Default constructor for a cursor with nothing left to visit (Public)
+    stackSize = 0;
+}
+
+void TreeCursor::pushLeftEdge(BSTNode* node) { // Remembers node and all of its left descendants, the smallest on top
+    while (node != nullptr) {
+        stack[stackSize++] = node;
+        node = node->left;
+    }
+}
+
+void TreeCursor::pushPosition(BSTNode* node, int index) { // Remembers the path to the node at the passed in position of node's subtree, keeping only the nodes still to be visited
+    while (node != nullptr) {
+        int leftSize = node->left == nullptr ? 0 : node->left->size;
+        if (index < leftSize) { // The current node comes after the position, so it is visited once its left subtree is done
+            stack[stackSize++] = node;
+            node = node->left;
+        }
+        else if (index == leftSize) {
+            stack[stackSize++] = node;
+            break;
+        }
+        else { // The current node and its left subtree come before the position, so they are never visited
+            index -= leftSize + 1;
+            node = node->right;
+        }
+    }
+}
+
+const CourseObject* TreeCursor::Peek() const { // Returns the next course in alphanumeric order without moving past it, or nullptr once every course has been visited (Public)
+    return stackSize == 0 ? nullptr : &stack[stackSize - 1]->courseObject;
+}
+
+const CourseObject* TreeCursor::Next() { // Returns the next course in alphanumeric order and moves past it, or nullptr once every course has been visited (Public)
+    if (stackSize == 0) {
+        return nullptr;
+    }
+    BSTNode* node = stack[--stackSize];
+    pushLeftEdge(node->right); // Everything in the right subtree comes before the ancestors still on the stack
+    return &node->courseObject;
+}
+
+void TreeCursor::Skip(int count) { // Moves past the next count courses in O(log n), skipping whole subtrees by their sizes instead of visiting them (Public)
+    while (count > 0 && stackSize > 0) {
+        BSTNode* node = stack[--stackSize];
+        int rightSize = node->right == nullptr ? 0 : node->right->size;
+        if (count <= rightSize) { // The new position is inside the right subtree, which comes before the ancestors still on the stack
+            pushPosition(node->right, count - 1);
+            return;
+        }
+        count -= rightSize + 1; // The node and its right subtree are skipped, leaving the rest of the count for the ancestors
+    }
+}
+
+bool TreeCursor::AtEnd() const { // Checks if every course has been visited (Public)
+    return stackSize == 0;
+}
+
+template <typename Visitor>
+void BinarySearchTree::ForEachInOrder(Visitor visit) const { // In-order traversal of the BinarySearchTree that passes each courseObject to visit, using an explicit stack of ancestors instead of recursion (Public)
+    BSTNode* stack[MAX_TREE_HEIGHT]; // Holds the ancestors whose left subtrees are still being visited
+    int stackSize = 0;
+    BSTNode* node = root;
+    while (node != nullptr || stackSize > 0) {
+        while (node != nullptr) { // Walk down the left subtree, remembering each ancestor
+            stack[stackSize++] = node;
+            node = node->left;
+        }
+        node = stack[--stackSize];
+        visit(node->courseObject); // Visit the courseObject at the current node
+        node = node->right; // Traverse the right subtree next
+    }
+}
+
+void BinarySearchTree::Insert(CourseObject&& courseObject) { // Insert a CourseObject into the BinarySearchTree, moving it into its node, and copying the path to it instead of changing any existing node, so trees sharing those nodes are unaffected (Public)
+    if (root == nullptr) { // If the tree is empty, create a new root node with the passed in courseObject
+        root = allocateNode(move(courseObject));
+    }
+    else {
+        root = addNode(root, move(courseObject)); // Otherwise, call a function to add the courseObject as a node and rebalance the tree
+    }
+}
+
+void BinarySearchTree::BuildFromSorted(vector<CourseObject>& sortedCourses, bool copyText) { // Replaces the tree's contents with courses already sorted by unique course number, building a perfectly balanced tree in O(n), and copying their text unless the caller keeps it alive for as long as the tree (Public)
+    destroyTree();
+    if (sortedCourses.empty()) {
+        return;
+    }
+    unordered_set<string_view> internTable; // Canonical copy of each course number while the tree is built, released before returning so freeing the tree stays a single arena reset
+    if (copyText) {
+        internTable.reserve(sortedCourses.size());
+    }
+    BSTNode* nodes = static_cast<BSTNode*>(arena->Allocate(sortedCourses.size() * sizeof(BSTNode), alignof(BSTNode))); // One array, in order, so in-order walks read memory front to back
+    for (size_t i = 0; i < sortedCourses.size(); ++i) {
+        if (copyText) {
+            storeCourseObject(sortedCourses[i], internTable); // Copy the course's text into the arena so the caller's buffers may be released
+        }
+        new (&nodes[i]) BSTNode(move(sortedCourses[i]));
+    }
+    root = linkBalanced(nodes, 0, sortedCourses.size());
+    builtBytes = arena->ReservedBytes();
+}
+
+BSTNode* BinarySearchTree::linkBalanced(BSTNode* nodes, size_t first, size_t last) { // Links nodes[first] up to nodes[last] into a perfectly balanced subtree, children before parents, and returns its root
+    if (first >= last) {
+        return nullptr;
+    }
+    size_t middle = first + (last - first) / 2; // Recursion only goes as deep as the finished tree is tall
+    BSTNode* node = &nodes[middle];
+    node->left = linkBalanced(nodes, first, middle);
+    node->right = linkBalanced(nodes, middle + 1, last);
+    updateNode(node);
+    return node;
+}
+
+void BinarySearchTree::ShareNodes(const BinarySearchTree& other) { // Replaces the tree's contents with other's courses in O(1) by sharing its nodes and text, keeping other's arenas alive for as long as this tree uses them (Public)
+    destroyTree();
+    root = other.root;
+    sharedArenas = other.sharedArenas;
+    if (other.arena->ReservedBytes() != 0) { // A tree that never allocated has nothing to keep alive
+        sharedArenas.push_back(other.arena);
+    }
+    builtBytes = other.builtBytes;
+}
+
+size_t BinarySearchTree::RetainedBytes() const { // Returns the bytes in every arena the tree keeps alive, including the nodes it has replaced (Public)
+    size_t bytes = arena->ReservedBytes();
+    for (const shared_ptr<const CatalogArena>& sharedArena : sharedArenas) {
+        bytes += sharedArena->ReservedBytes();
+    }
+    return bytes;
+}
+
+bool BinarySearchTree::NeedsCompaction() const { // Checks if the tree keeps so much more alive than its last full build that copying its courses would pay for itself, which only happens once changes worth that build have piled up (Public)
+    return RetainedBytes() > COMPACTION_RATIO * builtBytes;
+}
+
+void BinarySearchTree::Compact(const vector<int>& firstPrerequisites, const vector<int>& prerequisiteIds) { // Copies every course into a new arena in O(n), pointing the prerequisites of the course at position id at the copied course numbers of prerequisiteIds[firstPrerequisites[id]] up to prerequisiteIds[firstPrerequisites[id + 1]], so nothing has to be interned (Public)
+    vector<shared_ptr<const CatalogArena>> oldArenas = sharedArenas; // Keeps the current text alive until it has been copied
+    oldArenas.push_back(arena);
+    vector<CourseObject> courses;
+    courses.reserve(Size());
+    ForEachInOrder([&courses](const CourseObject& courseObject) { courses.push_back(courseObject); });
+    destroyTree();
+    if (courses.empty()) {
+        return;
+    }
+    BSTNode* nodes = static_cast<BSTNode*>(arena->Allocate(courses.size() * sizeof(BSTNode), alignof(BSTNode)));
+    string_view* prerequisites = prerequisiteIds.empty() ? nullptr : static_cast<string_view*>(arena->Allocate(prerequisiteIds.size() * sizeof(string_view), alignof(string_view))); // Every course's prerequisites, in one array
+    for (CourseObject& courseObject : courses) { // Every course number is copied before any prerequisite refers to it
+        courseObject.courseNumber = storeString(courseObject.courseNumber);
+        courseObject.name = storeString(courseObject.name);
+    }
+    for (size_t id = 0; id < courses.size(); ++id) {
+        for (int i = firstPrerequisites[id]; i < firstPrerequisites[id + 1]; ++i) {
+            prerequisites[i] = courses[prerequisiteIds[i]].courseNumber;
+        }
+        courses[id].prerequisites.items = firstPrerequisites[id + 1] > firstPrerequisites[id] ? prerequisites + firstPrerequisites[id] : nullptr;
+        courses[id].prerequisites.count = static_cast<size_t>(firstPrerequisites[id + 1] - firstPrerequisites[id]);
+        new (&nodes[id]) BSTNode(move(courses[id]));
+    }
+    root = linkBalanced(nodes, 0, courses.size());
+    builtBytes = arena->ReservedBytes();
+}
+
+void BinarySearchTree::Remove(string_view courseNumber) { // Remove a courseObject from the BinarySearchTree, copying the path to it instead of changing any existing node, so trees sharing those nodes are unaffected (Public)
+    root = removeNode(root, courseNumber); // Call a function to remove the node with the passed in courseNumber from the BinarySearchTree
+}
+
+const CourseObject* BinarySearchTree::Search(string_view courseNumber) const { // Search for a courseObject, returning a pointer to it inside the tree or nullptr if it is not found (Public)
+    ScopedLatency timer(METRIC_SEARCH);
+    CourseKey key = makeCourseKey(courseNumber); // Pack and upper-case the courseNumber once for every comparison below
+    BSTNode* currentNode = root; // Start the search from the root of the tree
+    nodesSearched = 0;
+    while (currentNode != nullptr) {
+        int comparison = compareCourseKeys(key, currentNode->key());
+        if (comparison == 0) { // If the courseNumber matches, return the found courseObject
+            nodesSearched++;
+            metrics.RecordComparisons(nodesSearched);
+            return &currentNode->courseObject; // The courseObject is not copied, and stays valid until it is removed or the tree is destroyed
+        }
+        else if (comparison < 0) { // Move to the left subtree if the passed in courseNumber is less than currentNode's courseNumber
+            currentNode = currentNode->left;
+            nodesSearched++;
+        }
+        else { // Move to the right subtree if the passed in courseNumber is greater than currentNode's courseNumber
+            currentNode = currentNode->right;
+            nodesSearched++;
+        }
+    }
+    metrics.RecordComparisons(nodesSearched);
+    return nullptr; // If the passed in courseNumber is not found, there is no courseObject to point to
+}
+
+void BinarySearchTree::MergeJoin(const CourseKey* sortedKeys, size_t count, const CourseObject** results) const { // Looks up many sorted keys in one in-order walk, skipping subtrees that sort before the next key, storing each match (or nullptr) in results (Public)
+    ScopedLatency timer(METRIC_BATCH);
+    BSTNode* stack[MAX_TREE_HEIGHT]; // Holds the ancestors whose left subtrees are still being walked
+    int stackSize = 0;
+    BSTNode* node = root;
+    size_t next = 0; // The smallest key not answered yet
+    int comparisons = 0; // Keys compared since the last key was answered, which are counted as that key's search
+    while (next < count && (node != nullptr || stackSize > 0)) {
+        while (node != nullptr) {
+            comparisons++;
+            if (compareCourseKeys(node->key(), sortedKeys[next]) < 0) { // This node and its left subtree sort before every key still to be answered
+                node = node->right;
+            }
+            else {
+                stack[stackSize++] = node;
+                node = node->left;
+            }
+        }
+        node = stack[--stackSize]; // Every course between the next key and this node has been walked, so keys before this node are missing
+        int comparison;
+        while (next < count && (comparisons++, comparison = compareCourseKeys(sortedKeys[next], node->key())) <= 0) {
+            results[next++] = comparison == 0 ? &node->courseObject : nullptr;
+            metrics.RecordComparisons(comparisons);
+            comparisons = 0;
+        }
+        node = node->right;
+    }
+    while (next < count) { // Keys after the last course in the tree
+        results[next++] = nullptr;
+        metrics.RecordComparisons(comparisons);
+        comparisons = 0;
+    }
+}
+
+int BinarySearchTree::height(BSTNode* node) { // Returns the height of a subtree, where an empty subtree has a height of 0
+    return node == nullptr ? 0 : node->height;
+}
+
+int BinarySearchTree::subtreeSize(BSTNode* node) { // Returns the number of nodes in a subtree, where an empty subtree has a size of 0
+    return node == nullptr ? 0 : node->size;
+}
+
+void BinarySearchTree::updateNode(BSTNode* node) { // Recalculates a node's height and subtree size from its children
+    node->height = 1 + max(height(node->left), height(node->right));
+    node->size = 1 + subtreeSize(node->left) + subtreeSize(node->right);
+}
+
+BSTNode* BinarySearchTree::rotateLeft(BSTNode* node) { // Rotates a subtree to the left and returns its new root
+    BSTNode* newRoot = node->right;
+    node->right = newRoot->left;
+    newRoot->left = node;
+    updateNode(node); // The old root is now the lower node, so it is updated first
+    updateNode(newRoot);
+    return newRoot;
+}
+
+BSTNode* BinarySearchTree::rotateRight(BSTNode* node) { // Rotates a subtree to the right and returns its new root
+    BSTNode* newRoot = node->left;
+    node->left = newRoot->right;
+    newRoot->right = node;
+    updateNode(node); // The old root is now the lower node, so it is updated first
+    updateNode(newRoot);
+    return newRoot;
+}
+
+BSTNode* BinarySearchTree::rebalance(BSTNode* node) { // Updates a copied node's height and size and rotates it if its subtrees differ in height by more than one, copying the children a rotation moves
+    updateNode(node);
+    int balance = height(node->left) - height(node->right);
+    if (balance > 1) { // Left side is too tall
+        node->left = copyNode(node->left); // A removal leaves the taller side untouched, so its nodes may still be shared
+        if (height(node->left->left) < height(node->left->right)) { // Left-right case needs the left child rotated first
+            node->left->right = copyNode(node->left->right);
+            node->left = rotateLeft(node->left);
+        }
+        return rotateRight(node);
+    }
+    if (balance < -1) { // Right side is too tall
+        node->right = copyNode(node->right);
+        if (height(node->right->right) < height(node->right->left)) { // Right-left case needs the right child rotated first
+            node->right->left = copyNode(node->right->left);
+            node->right = rotateRight(node->right);
+        }
+        return rotateLeft(node);
+    }
+    return node;
+}
+
+BSTNode* BinarySearchTree::retrace(BSTNode* path[], bool wentLeft[], int depth, BSTNode* child) { // Walks back up a recorded path of copied nodes, relinking and rebalancing each ancestor, and returns the new root
+    for (int i = depth - 1; i >= 0; --i) {
+        BSTNode* parent = path[i];
+        if (wentLeft[i]) { // Reattach the (possibly rotated) subtree on the side the search went down
+            parent->left = child;
+        }
+        else {
+            parent->right = child;
+        }
+        child = rebalance(parent);
+    }
+    return child;
+}
+
+BSTNode* BinarySearchTree::addNode(BSTNode* node, CourseObject&& courseObject) { // Add a courseObject below the passed in node and return the rebalanced subtree root
+    BSTNode* path[MAX_TREE_HEIGHT]; // Records every node passed on the way down so the tree can be rebalanced on the way back up
+    bool wentLeft[MAX_TREE_HEIGHT];
+    int depth = 0;
+    CourseKey key = makeCourseKey(courseObject.courseNumber);
+    BSTNode* currentNode = node;
+    while (currentNode != nullptr) {
+        path[depth] = copyNode(currentNode); // Every ancestor changes, so each is copied on the way down
+        wentLeft[depth] = compareCourseKeys(key, currentNode->key()) < 0; // Equal course numbers go to the right subtree
+        currentNode = wentLeft[depth] ? currentNode->left : currentNode->right;
+        depth++;
+    }
+    return retrace(path, wentLeft, depth, allocateNode(move(courseObject))); // Attach the new node in the empty spot and rebalance every ancestor
+}
+
+BSTNode* BinarySearchTree::allocateNode(CourseObject&& courseObject) { // Creates a node in the arena
+    void* memory = arena->Allocate(sizeof(BSTNode), alignof(BSTNode));
+    unordered_set<string_view> internTable; // Prerequisites that are already courses in the tree share their course numbers' copies
+    for (string_view prerequisite : courseObject.prerequisites) {
+        BSTNode* course = findNode(prerequisite);
+        if (course != nullptr && course->courseObject.courseNumber == prerequisite) {
+            internTable.insert(course->courseObject.courseNumber);
+        }
+    }
+    storeCourseObject(courseObject, internTable); // Copy the course's text into the arena so the caller's buffers may be released
+    return new (memory) BSTNode(move(courseObject));
+}
+
+BSTNode* BinarySearchTree::findNode(string_view courseNumber) const { // Returns the node holding courseNumber, ignoring case, or nullptr, without recording a search
+    CourseKey key = makeCourseKey(courseNumber);
+    BSTNode* node = root;
+    int comparison;
+    while (node != nullptr && (comparison = compareCourseKeys(key, node->key())) != 0) {
+        node = comparison < 0 ? node->left : node->right;
+    }
+    return node;
+}
+
+BSTNode* BinarySearchTree::copyNode(const BSTNode* node) { // Creates a copy of a node in the arena, sharing its course's text and its children
+    return new (arena->Allocate(sizeof(BSTNode), alignof(BSTNode))) BSTNode(*node);
+}
+
+string_view BinarySearchTree::storeString(string_view text) { // Copies text into the arena and returns a view of the copy
+    if (text.empty()) {
+        return string_view();
+    }
+    char* copy = static_cast<char*>(arena->Allocate(text.size(), 1));
+    memcpy(copy, text.data(), text.size());
+    return string_view(copy, text.size());
+}
+
+string_view BinarySearchTree::internString(string_view text, unordered_set<string_view>& internTable) { // Returns the canonical arena copy of text, storing it the first time it is seen
+    auto found = internTable.find(text);
+    if (found != internTable.end()) {
+        return *found;
+    }
+    string_view stored = storeString(text);
+    internTable.insert(stored);
+    return stored;
+}
+
+void BinarySearchTree::storeCourseObject(CourseObject& courseObject, unordered_set<string_view>& internTable) { // Points a CourseObject at arena copies of its text, with prerequisites pointing at the interned course numbers
+    courseObject.courseNumber = internString(courseObject.courseNumber, internTable);
+    courseObject.name = storeString(courseObject.name);
+    if (!courseObject.prerequisites.empty()) {
+        string_view* items = static_cast<string_view*>(arena->Allocate(courseObject.prerequisites.size() * sizeof(string_view), alignof(string_view)));
+        size_t count = 0;
+        for (string_view prerequisite : courseObject.prerequisites) {
+            items[count++] = internString(prerequisite, internTable);
+        }
+        courseObject.prerequisites.items = items;
+        courseObject.prerequisites.count = count;
+    }
+}
+
+void BinarySearchTree::destroyTree() { // Destroy every node and string in the BinarySearchTree with a single arena reset, or leave them to a newer tree that still shares them
+    root = nullptr;
+    sharedArenas.clear();
+    if (arena.use_count() == 1) {
+        arena->Reset();
+    }
+    else {
+        arena = make_shared<CatalogArena>();
+    }
+}
+
+BSTNode* BinarySearchTree::removeNode(BSTNode* node, string_view courseNumber) { // Removes a node from the BinarySearchTree and returns the rebalanced subtree root, which applying a delta file uses to delete and modify courses
+    BSTNode* path[MAX_TREE_HEIGHT]; // Records every node passed on the way down so the tree can be rebalanced on the way back up
+    bool wentLeft[MAX_TREE_HEIGHT];
+    int depth = 0;
+    CourseKey key = makeCourseKey(courseNumber);
+    BSTNode* currentNode = node;
+    int comparison = 0;
+    while (currentNode != nullptr && (comparison = compareCourseKeys(key, currentNode->key())) != 0) {
+        path[depth] = currentNode;
+        wentLeft[depth] = comparison < 0;
+        currentNode = wentLeft[depth] ? currentNode->left : currentNode->right;
+        depth++;
+    }
+    if (currentNode == nullptr) { // If the courseNumber was not found, there is nothing to remove
+        return node;
+    }
+    for (int i = 0; i < depth; ++i) { // Every ancestor changes, so each is copied once the course is known to be in the tree
+        path[i] = copyNode(path[i]);
+    }
+    BSTNode* replacement;
+    if (currentNode->left == nullptr || currentNode->right == nullptr) { // If the node has at most one child, replace it with that child
+        replacement = currentNode->left != nullptr ? currentNode->left : currentNode->right;
+    }
+    else { // Otherwise, copy this node holding the minimum courseObject of the right subtree, and remove that minimum node instead
+        BSTNode* copiedNode = copyNode(currentNode);
+        path[depth] = copiedNode;
+        wentLeft[depth] = false;
+        depth++;
+        BSTNode* minNode = currentNode->right;
+        while (minNode->left != nullptr) {
+            path[depth] = copyNode(minNode);
+            wentLeft[depth] = true;
+            depth++;
+            minNode = minNode->left;
+        }
+        copiedNode->courseObject = minNode->courseObject;
+        copiedNode->packedKey = minNode->packedKey;
+        replacement = minNode->right;
+    }
+    return retrace(path, wentLeft, depth, replacement); // Rebalance every ancestor of the removed node
+}
+
+int countTrailingZeros(unsigned int mask) { // Returns the position of the lowest set bit in a non-zero mask
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+
+int countTrailingZeros(unsigned long long mask) { // Returns the position of the lowest set bit in a non-zero 64-bit mask
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, mask);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(mask);
+#endif
+}
+
+LatencyHistogram::LatencyHistogram() { // Default constructor for an empty LatencyHistogram (Public)
+    for (atomic<uint64_t>& bucket : buckets) {
+        bucket.store(0, memory_order_relaxed);
+    }
+    count.store(0, memory_order_relaxed);
+    totalNanoseconds.store(0, memory_order_relaxed);
+    maximumNanoseconds.store(0, memory_order_relaxed);
+}
+
+void addToCounter(atomic<uint64_t>& counter, uint64_t amount) { // Adds to a counter that only the calling thread writes, without the locked instruction fetch_add needs
+    counter.store(counter.load(memory_order_relaxed) + amount, memory_order_relaxed);
+}
+
+void LatencyHistogram::Record(uint64_t nanoseconds) { // Adds one latency to the histogram, from the one thread that owns it (Public)
+    int bucket = 0; // The number of bits needed to hold the latency
+    for (uint64_t remaining = nanoseconds; remaining != 0 && bucket < LATENCY_BUCKETS - 1; remaining >>= 1) {
+        bucket++;
+    }
+    addToCounter(buckets[bucket], 1); // Readers only need each counter on its own, so no ordering between threads is needed
+    addToCounter(count, 1);
+    addToCounter(totalNanoseconds, nanoseconds);
+    if (nanoseconds > maximumNanoseconds.load(memory_order_relaxed)) {
+        maximumNanoseconds.store(nanoseconds, memory_order_relaxed);
+    }
+}
+
+void LatencyHistogram::Merge(const LatencyHistogram& other) { // Adds every latency of another histogram to this one, which the calling thread owns (Public)
+    for (int bucket = 0; bucket < LATENCY_BUCKETS; ++bucket) {
+        addToCounter(buckets[bucket], other.buckets[bucket].load(memory_order_relaxed));
+    }
+    addToCounter(count, other.count.load(memory_order_relaxed));
+    addToCounter(totalNanoseconds, other.totalNanoseconds.load(memory_order_relaxed));
+    maximumNanoseconds.store(max(maximumNanoseconds.load(memory_order_relaxed), other.maximumNanoseconds.load(memory_order_relaxed)), memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::percentile(double fraction) const { // Returns the upper bound of the bucket holding the given fraction of latencies, never more than the maximum
+    uint64_t total = count.load(memory_order_relaxed), seen = 0;
+    uint64_t rank = static_cast<uint64_t>(fraction * total + 0.999999);
+    for (int bucket = 0; bucket < LATENCY_BUCKETS; ++bucket) {
+        seen += buckets[bucket].load(memory_order_relaxed);
+        if (seen >= rank && seen > 0) {
+            return min((1ULL << bucket) - 1, static_cast<unsigned long long>(maximumNanoseconds.load(memory_order_relaxed)));
+        }
+    }
+    return maximumNanoseconds.load(memory_order_relaxed);
+}
+
+void LatencyHistogram::WriteJson(ostream& out, int sampleInterval) const { // Writes the histogram as a JSON object, with only its non-empty buckets, noting when only one operation in sampleInterval was timed (Public)
+    uint64_t total = count.load(memory_order_relaxed);
+    out << "{";
+    if (sampleInterval > 1) {
+        out << "\"sampledOneIn\":" << sampleInterval << ",";
+    }
+    out << "\"count\":" << total << ",\"totalNs\":" << totalNanoseconds.load(memory_order_relaxed)
+        << ",\"meanNs\":" << (total == 0 ? 0 : totalNanoseconds.load(memory_order_relaxed) / total)
+        << ",\"p50Ns\":" << percentile(0.5) << ",\"p90Ns\":" << percentile(0.9) << ",\"p99Ns\":" << percentile(0.99)
+        << ",\"maxNs\":" << maximumNanoseconds.load(memory_order_relaxed) << ",\"bucketsBelowNs\":{";
+    bool firstBucket = true;
+    for (int bucket = 0; bucket < LATENCY_BUCKETS; ++bucket) {
+        uint64_t bucketCount = buckets[bucket].load(memory_order_relaxed);
+        if (bucketCount != 0) {
+            out << (firstBucket ? "" : ",") << "\"" << (bucket == LATENCY_BUCKETS - 1 ? UINT64_MAX : 1ULL << bucket) << "\":" << bucketCount;
+            firstBucket = false;
+        }
+    }
+    out << "}}";
+}
+
+MetricShard::MetricShard() { // Default constructor with every counter at zero, timing the first search
+    for (atomic<uint64_t>& comparisonCount : comparisonCounts) {
+        comparisonCount.store(0, memory_order_relaxed);
+    }
+    searchesUntilSample = 0;
+}
+
+MetricShardLease::~MetricShardLease() { // Hands the shard back when its thread exits, keeping its counts for the next thread to add to
+    if (shard != nullptr) {
+        lock_guard<mutex> lock(metrics.shardMutex);
+        metrics.idleShards.push_back(shard);
+    }
+}
+
+OperationMetrics::OperationMetrics() { // Default constructor with every counter at zero (Public)
+    systemAllocations.store(0, memory_order_relaxed);
+    bytesAllocated.store(0, memory_order_relaxed);
+    bytesReleased.store(0, memory_order_relaxed);
+}
+
+MetricShard& OperationMetrics::localShard() { // Returns the calling thread's shard, claiming one the first time the thread records a metric
+    static thread_local MetricShardLease lease;
+    if (lease.shard == nullptr) {
+        lock_guard<mutex> lock(shardMutex);
+        if (!idleShards.empty()) {
+            lease.shard = idleShards.back();
+            idleShards.pop_back();
+        }
+        else {
+            shards.push_back(make_unique<MetricShard>());
+            lease.shard = shards.back().get();
+        }
+    }
+    return *lease.shard;
+}
+
+bool OperationMetrics::ShouldTime(MetricOperation operation) { // Checks if this occurrence of an operation should be timed, which is every time except for searches, which are sampled (Public)
+    if (operation != METRIC_SEARCH) {
+        return true;
+    }
+    MetricShard& shard = localShard();
+    if (shard.searchesUntilSample > 0) {
+        shard.searchesUntilSample--;
+        return false;
+    }
+    shard.searchesUntilSample = SEARCH_SAMPLE_INTERVAL - 1;
+    return true;
+}
+
+void OperationMetrics::RecordLatency(MetricOperation operation, uint64_t nanoseconds) { // Adds one latency for an operation (Public)
+    localShard().latencies[operation].Record(nanoseconds);
+}
+
+void OperationMetrics::RecordComparisons(int comparisons) { // Adds one search that compared the search key with the passed in number of keys (Public)
+    addToCounter(localShard().comparisonCounts[min(max(comparisons, 0), MAX_TREE_HEIGHT)], 1);
+}
+
+void OperationMetrics::RecordAllocation(size_t bytes) { // Adds one block requested from the system (Public)
+    systemAllocations.fetch_add(1, memory_order_relaxed);
+    bytesAllocated.fetch_add(bytes, memory_order_relaxed);
+}
+
+void OperationMetrics::RecordRelease(size_t bytes) { // Adds bytes returned to the system (Public)
+    bytesReleased.fetch_add(bytes, memory_order_relaxed);
+}
+
+void OperationMetrics::WriteJson(ostream& out, size_t catalogBytes) const { // Writes the latencies, search comparisons, and memory use, counting catalogBytes held outside the arenas, as members of a JSON object (Public)
+    MetricShard totals; // Every thread's shard added together
+    {
+        lock_guard<mutex> lock(shardMutex);
+        for (const unique_ptr<MetricShard>& shard : shards) {
+            for (int operation = 0; operation < METRIC_OPERATION_COUNT; ++operation) {
+                totals.latencies[operation].Merge(shard->latencies[operation]);
+            }
+            for (int i = 0; i <= MAX_TREE_HEIGHT; ++i) {
+                addToCounter(totals.comparisonCounts[i], shard->comparisonCounts[i].load(memory_order_relaxed));
+            }
+        }
+    }
+    out << "\"latencies\":{";
+    for (int operation = 0; operation < METRIC_OPERATION_COUNT; ++operation) {
+        out << (operation == 0 ? "\n    " : ",\n    ") << "\"" << METRIC_OPERATION_NAMES[operation] << "\":";
+        totals.latencies[operation].WriteJson(out, operation == METRIC_SEARCH ? SEARCH_SAMPLE_INTERVAL : 1);
+    }
+    uint64_t searches = 0, comparisons = 0;
+    int mostComparisons = 0;
+    for (int i = 0; i <= MAX_TREE_HEIGHT; ++i) {
+        uint64_t searchCount = totals.comparisonCounts[i].load(memory_order_relaxed);
+        searches += searchCount;
+        comparisons += searchCount * i;
+        mostComparisons = searchCount != 0 ? i : mostComparisons;
+    }
+    out << "\n  },\n  \"comparisonsPerSearch\":{\"searches\":" << searches << ",\"mean\":" << (searches == 0 ? 0.0 : static_cast<double>(comparisons) / searches)
+        << ",\"max\":" << mostComparisons << ",\"histogram\":{";
+    bool firstCount = true;
+    for (int i = 0; i <= MAX_TREE_HEIGHT; ++i) {
+        uint64_t searchCount = totals.comparisonCounts[i].load(memory_order_relaxed);
+        if (searchCount != 0) {
+            out << (firstCount ? "" : ",") << "\"" << i << "\":" << searchCount;
+            firstCount = false;
+        }
+    }
+    uint64_t allocated = bytesAllocated.load(memory_order_relaxed), released = bytesReleased.load(memory_order_relaxed);
+    out << "}},\n  \"memory\":{\"systemAllocations\":" << systemAllocations.load(memory_order_relaxed) << ",\"bytesAllocated\":" << allocated
+        << ",\"arenaBytesResident\":" << allocated - released << ",\"catalogBytesOutsideArenas\":" << catalogBytes << ",\"bytesResident\":" << allocated - released + catalogBytes << "}";
+}
+
+ScopedLatency::ScopedLatency(MetricOperation timedOperation) { // Starts timing an operation (Public)
+    operation = timedOperation;
+    stopped = !metrics.ShouldTime(operation); // An occurrence that is not sampled is treated as already recorded, so the clock is never read
+    if (!stopped) {
+        start = chrono::steady_clock::now();
+    }
+}
+
+ScopedLatency::~ScopedLatency() { // Records the time since the operation started, unless Stop already has (Public)
+    Stop();
+}
+
+void ScopedLatency::Stop() { // Records the time since the operation started, for operations that end before the timer goes out of scope (Public)
+    if (!stopped) {
+        metrics.RecordLatency(operation, static_cast<uint64_t>(chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count()));
+        stopped = true;
+    }
+}
+
+CatalogIndex::CatalogIndex() { // Default constructor for an empty CatalogIndex (Public)
+    completeLevels = 0;
+}
+
+void CatalogIndex::Build(const BinarySearchTree& tree) { // Freezes the courses in the passed in tree into Eytzinger order (Public)
+    Clear();
+    size_t count = static_cast<size_t>(tree.Size());
+    courses.reserve(count);
+    tree.ForEachInOrder([this](const CourseObject& courseObject) { courses.push_back(&courseObject); });
+    keys.resize(count + 1); // Position 0 is never used, so the root is at position 1
+    entries.resize(count + 1);
+    size_t position = 1;
+    while (2 * position <= count) { // The smallest course is at the leftmost position of the implicit tree
+        position *= 2;
+    }
+    for (size_t i = 0; i < count; ++i) { // Walk the implicit tree in order, filling each position with the next smallest course
+        keys[position] = makeCourseKey(courses[i]->courseNumber).packed;
+        entries[position] = { courses[i], static_cast<int>(i) };
+        if (2 * position + 1 <= count) { // Continue with the leftmost position of the right subtree
+            position = 2 * position + 1;
+            while (2 * position <= count) {
+                position *= 2;
+            }
+        }
+        else { // Otherwise climb until arriving from a left child
+            while (position & 1) {
+                position >>= 1;
+            }
+            position >>= 1;
+        }
+    }
+    completeLevels = 0;
+    while ((static_cast<size_t>(2) << completeLevels) - 1 <= count) { // A tree with 2^L - 1 positions has L complete levels
+        completeLevels++;
+    }
+}
+
+void CatalogIndex::Export(vector<uint64_t>& eytzingerKeys, vector<int32_t>& eytzingerIds) const { // Copies out the keys and the ID stored at each Eytzinger position, position 0 included, so they can be saved (Public)
+    eytzingerKeys.assign(keys.begin(), keys.end());
+    eytzingerIds.resize(entries.size());
+    for (size_t position = 0; position < entries.size(); ++position) {
+        eytzingerIds[position] = position == 0 ? -1 : entries[position].id; // Position 0 is never used
+    }
+}
+
+bool CatalogIndex::Import(const uint64_t* eytzingerKeys, const int32_t* eytzingerIds, const BinarySearchTree& tree) { // Rebuilds the index from saved keys and IDs for the courses in tree, returning false if an ID is out of range (Public)
+    Clear();
+    size_t count = static_cast<size_t>(tree.Size());
+    courses.reserve(count);
+    tree.ForEachInOrder([this](const CourseObject& courseObject) { courses.push_back(&courseObject); });
+    keys.assign(eytzingerKeys, eytzingerKeys + count + 1); // One copy of the keys, so searches keep their cache-line alignment
+    entries.resize(count + 1);
+    for (size_t position = 1; position <= count; ++position) { // Point each saved ID back at its course
+        int32_t id = eytzingerIds[position];
+        if (id < 0 || static_cast<size_t>(id) >= count) {
+            Clear();
+            return false;
+        }
+        entries[position] = { courses[id], id };
+    }
+    completeLevels = 0;
+    while ((static_cast<size_t>(2) << completeLevels) - 1 <= count) { // A tree with 2^L - 1 positions has L complete levels
+        completeLevels++;
+    }
+    return true;
+}
+
+void CatalogIndex::Clear() { // Empties the index, for example after a failed load (Public)
+    keys.clear();
+    entries.clear();
+    courses.clear();
+    completeLevels = 0;
+}
+
+int CatalogIndex::Size() const { // Returns the number of courses in the index (Public)
+    return static_cast<int>(courses.size());
+}
+
+size_t CatalogIndex::MemoryBytes() const { // Returns the bytes held by the index's arrays (Public)
+    return keys.capacity() * sizeof(uint64_t) + entries.capacity() * sizeof(IndexEntry) + courses.capacity() * sizeof(const CourseObject*);
+}
+
+size_t CatalogIndex::descend(uint64_t packed, size_t position) const { // Continues a search from position down to the bottom of the implicit tree
+    size_t count = courses.size();
+    while (position <= count) { // Every search compares against one key per level, choosing the child with arithmetic instead of a branch
+#if defined(__GNUC__)
+        __builtin_prefetch(keys.data() + (position * 8 < keys.size() ? position * 8 : 0)); // Start loading the cache line holding the keys three levels down
+#endif
+        position = 2 * position + (keys[position] < packed);
+        nodesSearched++;
+    }
+    return position;
+}
+
+IndexEntry CatalogIndex::resolve(const CourseKey& key, size_t position) const { // Turns the position where a search left the implicit tree into the matching course and ID, or { nullptr, -1 }
+    const IndexEntry NOT_FOUND = { nullptr, -1 };
+    position >>= countTrailingZeros(static_cast<unsigned long long>(~position)) + 1; // Undo the right turns taken after the last left turn, leaving the first key that is not less than the search key
+    if (position == 0) { // Every course sorts before the search key
+        return NOT_FOUND;
+    }
+    if (key.text.size() <= PACKED_KEY_LENGTH) { // A short course number fits in its packed key completely, and sorts before longer ones sharing its packed characters, so it can only be at this position
+        const IndexEntry& entry = entries[position];
+        return keys[position] == key.packed && entry.course->courseNumber.size() <= PACKED_KEY_LENGTH ? entry : NOT_FOUND;
+    }
+    auto rangeEnd = courses.end(); // Only the courses sharing the key's packed characters need their text compared
+    if (key.packed != UINT64_MAX) {
+        size_t endPosition = descend(key.packed + 1, 1);
+        endPosition >>= countTrailingZeros(static_cast<unsigned long long>(~endPosition)) + 1;
+        if (endPosition != 0) {
+            rangeEnd = courses.begin() + entries[endPosition].id;
+        }
+    }
+    auto found = partition_point(courses.begin() + entries[position].id, rangeEnd, [&key](const CourseObject* course) { // Longer course numbers that share their packed characters are told apart by the rest of their text
+        return compareCourseKeys(makeCourseKey(course->courseNumber), key) < 0;
+    });
+    if (found == rangeEnd || compareCourseKeys(makeCourseKey((*found)->courseNumber), key) != 0) {
+        return NOT_FOUND;
+    }
+    return { *found, static_cast<int>(found - courses.begin()) };
+}
+
+const CourseObject* CatalogIndex::Find(string_view courseNumber) const { // Finds a course by its course number, ignoring case, returning nullptr if it is not found (Public)
+    ScopedLatency timer(METRIC_SEARCH);
+    CourseKey key = makeCourseKey(courseNumber);
+    nodesSearched = 0;
+    const CourseObject* found = resolve(key, descend(key.packed, 1)).course;
+    metrics.RecordComparisons(nodesSearched);
+    return found;
+}
+
+int CatalogIndex::FindId(string_view courseNumber) const { // Finds the ID (alphanumeric position) of a course by its course number, returning -1 if it is not found (Public)
+    CourseKey key = makeCourseKey(courseNumber);
+    nodesSearched = 0;
+    return resolve(key, descend(key.packed, 1)).id;
+}
+
+const CourseObject* CatalogIndex::CourseAt(int id) const { // Returns the course with the passed in ID (Public)
+    return courses[id];
+}
+
+void CatalogIndex::FindBatch(const string_view* courseNumbers, size_t count, const CourseObject** results) const { // Finds many courses at once, comparing four packed course numbers per step (Public)
+    ScopedLatency timer(METRIC_BATCH);
+    const size_t LANES = 4;
+    for (size_t first = 0; first < count; first += LANES) {
+        CourseKey queryKeys[LANES];
+        uint64_t packed[LANES];
+        size_t positions[LANES];
+        for (size_t lane = 0; lane < LANES; ++lane) { // Unused lanes of the last group repeat the group's first course number
+            queryKeys[lane] = makeCourseKey(courseNumbers[first + (first + lane < count ? lane : 0)]);
+            packed[lane] = queryKeys[lane].packed;
+        }
+#if defined(__AVX2__)
+        const __m256i signBit = _mm256_set1_epi64x(static_cast<long long>(0x8000000000000000ULL)); // Flipping the sign bit lets a signed comparison order unsigned keys
+        __m256i queries = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(packed)), signBit);
+        __m256i lanePositions = _mm256_set1_epi64x(1);
+        for (int level = 0; level < completeLevels; ++level) { // The complete levels always hold a key, so all four searches step down together
+            __m256i nodeKeys = _mm256_i64gather_epi64(reinterpret_cast<const long long*>(keys.data()), lanePositions, 8);
+            __m256i less = _mm256_cmpgt_epi64(queries, _mm256_xor_si256(nodeKeys, signBit)); // All ones where the node's key is less than the search key
+            lanePositions = _mm256_sub_epi64(_mm256_add_epi64(lanePositions, lanePositions), less); // Subtracting all ones adds one, choosing the right child
+        }
+        long long stored[LANES];
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(stored), lanePositions);
+        for (size_t lane = 0; lane < LANES; ++lane) {
+            positions[lane] = static_cast<size_t>(stored[lane]);
+        }
+#else
+        for (size_t lane = 0; lane < LANES; ++lane) {
+            positions[lane] = 1;
+        }
+        for (int level = 0; level < completeLevels; ++level) { // Interleaving the four searches lets their memory loads overlap
+            for (size_t lane = 0; lane < LANES; ++lane) {
+                positions[lane] = 2 * positions[lane] + (keys[positions[lane]] < packed[lane]);
+            }
+        }
+#endif
+        for (size_t lane = 0; lane < LANES && first + lane < count; ++lane) { // Finish the partly filled bottom level one search at a time
+            nodesSearched = completeLevels; // One key was compared on each complete level
+            results[first + lane] = resolve(queryKeys[lane], descend(packed[lane], positions[lane])).course;
+            metrics.RecordComparisons(nodesSearched);
+        }
+    }
+}
+
+PrerequisiteGraph::PrerequisiteGraph() { // Default constructor for an empty PrerequisiteGraph (Public)
+    index = nullptr;
+}
+
+bool PrerequisiteGraph::Build(const CatalogIndex& catalogIndex, vector<int>& cycle) { // Builds the graph for the courses in catalogIndex, returning false and filling cycle if the prerequisites form a cycle (Public)
+    Clear();
+    index = &catalogIndex;
+    int count = catalogIndex.Size();
+    prerequisiteStart.assign(count + 1, 0);
+    for (int id = 0; id < count; ++id) { // Store each course's prerequisites as IDs, one course after another
+        for (string_view prerequisite : catalogIndex.CourseAt(id)->prerequisites) {
+            prerequisiteIds.push_back(catalogIndex.FindId(prerequisite)); // Every prerequisite was checked to exist while loading
+        }
+        prerequisiteStart[id + 1] = static_cast<int>(prerequisiteIds.size());
+    }
+    return linkDependents(cycle);
+}
+
+bool PrerequisiteGraph::Import(const CatalogIndex& catalogIndex, vector<int>&& firstPrerequisites, vector<int>&& prerequisiteList, vector<int>& cycle) { // Builds the graph from saved prerequisite IDs, in the same layout Build uses, returning false and filling cycle if they form a cycle (Public)
+    Clear();
+    index = &catalogIndex;
+    prerequisiteStart = move(firstPrerequisites);
+    prerequisiteIds = move(prerequisiteList);
+    return linkDependents(cycle);
+}
+
+int PrerequisiteGraph::PrerequisiteId(int id, int i) const { // Returns the ID of the i-th direct prerequisite of a course (Public)
+    return prerequisiteIds[prerequisiteStart[id] + i];
+}
+
+int PrerequisiteGraph::PrerequisiteCount(int id) const { // Returns the number of direct prerequisites of a course (Public)
+    return prerequisiteStart[id + 1] - prerequisiteStart[id];
+}
+
+bool PrerequisiteGraph::linkDependents(vector<int>& cycle) { // Fills in the dependents and semesters from the prerequisites, returning false and filling cycle if the prerequisites form a cycle
+    int count = index->Size();
+    dependentStart.assign(count + 1, 0);
+    for (int prerequisiteId : prerequisiteIds) { // Count the dependents of each course, then turn the counts into starting positions
+        dependentStart[prerequisiteId + 1]++;
+    }
+    for (int id = 0; id < count; ++id) {
+        dependentStart[id + 1] += dependentStart[id];
+    }
+    dependentIds.resize(prerequisiteIds.size());
+    vector<int> nextDependent(dependentStart.begin(), dependentStart.end() - 1);
+    for (int id = 0; id < count; ++id) {
+        for (int edge = prerequisiteStart[id]; edge < prerequisiteStart[id + 1]; ++edge) {
+            dependentIds[nextDependent[prerequisiteIds[edge]]++] = id;
+        }
+    }
+    vector<int> remainingPrerequisites(count); // Kahn's algorithm: a course is ready once all of its prerequisites have been placed
+    vector<int> ready;
+    semesters.assign(count, 1);
+    for (int id = 0; id < count; ++id) {
+        remainingPrerequisites[id] = prerequisiteStart[id + 1] - prerequisiteStart[id];
+        if (remainingPrerequisites[id] == 0) {
+            ready.push_back(id);
+        }
+    }
+    int placed = 0;
+    while (!ready.empty()) {
+        int id = ready.back();
+        ready.pop_back();
+        placed++;
+        for (int edge = dependentStart[id]; edge < dependentStart[id + 1]; ++edge) { // A dependent can be taken the semester after its latest prerequisite
+            int dependent = dependentIds[edge];
+            semesters[dependent] = max(semesters[dependent], semesters[id] + 1);
+            if (--remainingPrerequisites[dependent] == 0) {
+                ready.push_back(dependent);
+            }
+        }
+    }
+    if (placed == count) {
+        return true;
+    }
+    cycle.clear(); // Every course left over requires another course that is left over, so following those prerequisites must come back around
+    vector<int> pathPosition(count, -1);
+    int id = 0;
+    while (remainingPrerequisites[id] == 0) {
+        id++;
+    }
+    vector<int> path;
+    while (pathPosition[id] < 0) {
+        pathPosition[id] = static_cast<int>(path.size());
+        path.push_back(id);
+        for (int edge = prerequisiteStart[id]; edge < prerequisiteStart[id + 1]; ++edge) {
+            if (remainingPrerequisites[prerequisiteIds[edge]] > 0) {
+                id = prerequisiteIds[edge];
+                break;
+            }
+        }
+    }
+    cycle.assign(path.begin() + pathPosition[id], path.end());
+    cycle.push_back(id); // End the cycle where it began so it reads as a chain of requirements
+    Clear();
+    return false;
+}
+
+void PrerequisiteGraph::Clear() { // Empties the graph, for example after a failed load (Public)
+    index = nullptr;
+    prerequisiteStart.clear();
+    prerequisiteIds.clear();
+    dependentStart.clear();
+    dependentIds.clear();
+    semesters.clear();
+    lock_guard<mutex> lock(closureMutex);
+    closureCache.clear();
+}
+
+int PrerequisiteGraph::Size() const { // Returns the number of courses in the graph (Public)
+    return static_cast<int>(semesters.size());
+}
+
+size_t PrerequisiteGraph::MemoryBytes() const { // Returns the bytes held by the graph's arrays and its cached closures (Public)
+    size_t bytes = (prerequisiteStart.capacity() + prerequisiteIds.capacity() + dependentStart.capacity() + dependentIds.capacity() + semesters.capacity()) * sizeof(int);
+    lock_guard<mutex> lock(closureMutex);
+    for (const auto& cached : closureCache) {
+        bytes += sizeof(cached) + sizeof(vector<uint64_t>) + cached.second->capacity() * sizeof(uint64_t);
+    }
+    return bytes;
+}
+
+int PrerequisiteGraph::Id(string_view courseNumber) const { // Returns the ID of a course number, or -1 if it is not in the graph (Public)
+    return index == nullptr ? -1 : index->FindId(courseNumber);
+}
+
+const CourseObject* PrerequisiteGraph::Course(int id) const { // Returns the course with the passed in ID (Public)
+    return index->CourseAt(id);
+}
+
+vector<int> PrerequisiteGraph::bitsToIds(const vector<uint64_t>& bits) { // Lists the IDs whose bits are set, in alphanumeric order
+    vector<int> ids;
+    for (size_t word = 0; word < bits.size(); ++word) {
+        uint64_t remaining = bits[word];
+        while (remaining != 0) {
+            ids.push_back(static_cast<int>(word * 64 + countTrailingZeros(static_cast<unsigned long long>(remaining))));
+            remaining &= remaining - 1; // Clear the lowest set bit
+        }
+    }
+    return ids;
+}
+
+void PrerequisiteGraph::markReachable(vector<uint64_t>& bits, int id, const vector<int>& start, const vector<int>& ids) { // Sets the bit of every course reachable from id by following the passed in edges
+    vector<int> stack(ids.begin() + start[id], ids.begin() + start[id + 1]);
+    while (!stack.empty()) {
+        int next = stack.back();
+        stack.pop_back();
+        uint64_t bit = 1ULL << (next % 64);
+        if (bits[next / 64] & bit) {
+            continue;
+        }
+        bits[next / 64] |= bit;
+        stack.insert(stack.end(), ids.begin() + start[next], ids.begin() + start[next + 1]);
+    }
+}
+
+vector<int> PrerequisiteGraph::reachable(int id, const vector<int>& start, const vector<int>& ids) const { // Lists every course reachable from id by following the passed in edges, in alphanumeric order
+    vector<uint64_t> visited((semesters.size() + 63) / 64, 0);
+    markReachable(visited, id, start, ids);
+    return bitsToIds(visited);
+}
+
+shared_ptr<const vector<uint64_t>> PrerequisiteGraph::Closure(int id) const { // Returns every prerequisite of the course, direct or indirect, as one bit per course ID (Public)
+    {
+        lock_guard<mutex> lock(closureMutex);
+        auto cached = closureCache.find(id);
+        if (cached != closureCache.end()) {
+            return cached->second;
+        }
+    }
+    auto bits = make_shared<vector<uint64_t>>((semesters.size() + 63) / 64, 0); // Computed outside the lock, so other queries are not held up
+    markReachable(*bits, id, prerequisiteStart, prerequisiteIds);
+    lock_guard<mutex> lock(closureMutex);
+    if (closureCache.size() < CLOSURE_CACHE_LIMIT) {
+        closureCache.emplace(id, bits);
+    }
+    return bits;
+}
+
+vector<int> PrerequisiteGraph::AllPrerequisites(int id) const { // Lists every course that must be taken before the course, in alphanumeric order (Public)
+    return bitsToIds(*Closure(id));
+}
+
+vector<int> PrerequisiteGraph::Dependents(int id, bool transitive) const { // Lists the courses the course unlocks, either directly or through any chain of prerequisites (Public)
+    if (!transitive) {
+        return vector<int>(dependentIds.begin() + dependentStart[id], dependentIds.begin() + dependentStart[id + 1]);
+    }
+    return reachable(id, dependentStart, dependentIds);
+}
+
+vector<vector<int>> PrerequisiteGraph::SemesterPlan(int id) const { // Orders the course and all of its prerequisites into semesters, each course coming after all of its prerequisites (Public)
+    vector<vector<int>> plan(semesters[id]);
+    for (int prerequisite : AllPrerequisites(id)) { // Every prerequisite of a prerequisite is also in the list, so each course's semester is the same as in the whole catalog
+        plan[semesters[prerequisite] - 1].push_back(prerequisite);
+    }
+    plan[semesters[id] - 1].push_back(id);
+    return plan;
+}
+
+MappedFile::MappedFile() { // Default constructor for a MappedFile that is not yet open (Public)
+    data = nullptr;
+    size = 0;
+}
+
+MappedFile::~MappedFile() { // Destructor for a MappedFile releases the mapping (Public)
+    Close();
+}
+
+bool MappedFile::Open(const string& filePath) { // Maps the file at filePath into memory and returns whether it was successful (Public)
+    Close(); // Release any file that was previously opened
+#if defined(_WIN32)
+    ifstream inputFile(filePath, ios::binary | ios::ate); // Open at the end so the size of the file is known
+    if (!inputFile.is_open()) {
+        return false;
+    }
+    buffer.resize(static_cast<size_t>(inputFile.tellg()));
+    inputFile.seekg(0);
+    inputFile.read(buffer.data(), buffer.size());
+    data = buffer.data();
+    size = buffer.size();
+    return true;
+#else
+    int fileDescriptor = open(filePath.c_str(), O_RDONLY);
+    if (fileDescriptor < 0) {
+        return false;
+    }
+    struct stat fileStatus;
+    if (fstat(fileDescriptor, &fileStatus) != 0 || !S_ISREG(fileStatus.st_mode)) { // Only regular files can be mapped
+        close(fileDescriptor);
+        return false;
+    }
+    size = static_cast<size_t>(fileStatus.st_size);
+    if (size > 0) { // An empty file cannot be mapped, but is still a valid (empty) file
+        void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+        if (mapping == MAP_FAILED) {
+            close(fileDescriptor);
+            size = 0;
+            return false;
+        }
+        madvise(mapping, size, MADV_SEQUENTIAL); // CSV and delta files are read once from start to finish, which a snapshot undoes with AdviseRandomAccess
+        data = static_cast<const char*>(mapping);
+    }
+    close(fileDescriptor); // The mapping stays valid after the file descriptor is closed
+    return true;
+#endif
+}
+
+void MappedFile::AdviseRandomAccess() { // Tells the system the mapping stays in use and is read in any order, so pages already read are kept instead of dropped behind a sequential reader (Public)
+#if !defined(_WIN32)
+    if (data != nullptr) {
+        madvise(const_cast<char*>(data), size, MADV_NORMAL); // Keeps ordinary readahead, which the snapshot's single pass over its records still benefits from
+    }
+#endif
+}
+
+void MappedFile::Close() { // Releases the mapped file, if any (Public)
+#if defined(_WIN32)
+    buffer.clear();
+#else
+    if (data != nullptr) {
+        munmap(const_cast<char*>(data), size);
+    }
+#endif
+    data = nullptr;
+    size = 0;
+}
+
+string_view MappedFile::Contents() const { // Returns the whole file as a string_view without copying it (Public)
+    if (data == nullptr) { // An empty file is never mapped, so it is viewed as an empty string rather than through a null pointer that memchr may not be passed
+        return string_view("", 0);
+    }
+    return string_view(data, size);
+}
+
+
+const char* findFieldEnd(const char* position, const char* end) { // Returns the first ',' or '\n' at or after position, or end if there is neither
+#if defined(__SSE2__) || defined(_M_X64)
+    const __m128i commas = _mm_set1_epi8(',');
+    const __m128i newlines = _mm_set1_epi8('\n');
+    while (end - position >= 16) { // Compare 16 characters at a time against both delimiters
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(position));
+        int mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(chunk, commas), _mm_cmpeq_epi8(chunk, newlines)));
+        if (mask != 0) {
+            return position + countTrailingZeros(static_cast<unsigned int>(mask));
+        }
+        position += 16;
+    }
+#endif
+    while (position < end && *position != ',' && *position != '\n') { // Check any remaining characters one at a time
+        position++;
+    }
+    return position;
+}
+
+string_view nextField(string_view& remaining, bool& endOfLine) { // Splits the next field off the front of remaining and reports whether it was the last field on its line
+    const char* fieldEnd = findFieldEnd(remaining.data(), remaining.data() + remaining.size());
+    size_t length = static_cast<size_t>(fieldEnd - remaining.data());
+    string_view field = remaining.substr(0, length);
+    endOfLine = length == remaining.size() || *fieldEnd == '\n';
+    remaining.remove_prefix(min(length + 1, remaining.size())); // Skip past the field and its delimiter
+    if (endOfLine && !field.empty() && field.back() == '\r') { // Files saved on Windows end each line with "\r\n"
+        field.remove_suffix(1);
+    }
+    return field;
+}
+
+string_view nextLine(string_view& remaining) { // Splits the next whole line off the front of remaining
+    const void* lineEnd = memchr(remaining.data(), '\n', remaining.size());
+    size_t length = lineEnd == nullptr ? remaining.size() : static_cast<size_t>(static_cast<const char*>(lineEnd) - remaining.data());
+    string_view line = remaining.substr(0, length);
+    remaining.remove_prefix(min(length + 1, remaining.size()));
+    if (!line.empty() && line.back() == '\r') {
+        line.remove_suffix(1);
+    }
+    return line;
+}
+
+int checkForFileFormatErrors(const CourseObject& newCourse) { // Checks the CourseObject variables for errors that can be found from its own line (missing prerequisites are resolved after the whole file is read)
+    if (newCourse.courseNumber.empty()) {
+        return 1; // Error code for blank course number
+    }
+    if (newCourse.name.empty()) {
+        return 2; // Error code for blank course name
+    }
+    CourseKey courseKey = makeCourseKey(newCourse.courseNumber);
+    for (string_view prerequisite : newCourse.prerequisites) {
+        if (compareCourseKeys(makeCourseKey(prerequisite), courseKey) == 0) {
+            return 3; // Error code for prerequisite equalling its own course number
+        }
+    }
+    return 0; // No errors found
+}
+
+int parseCourseLine(string_view& remaining, CourseObject& newCourse, vector<string_view>& prerequisites) { // Parses the next line of the input file into a CourseObject that views the file's text, and checks for file format errors
+    bool endOfLine = false;
+    prerequisites.clear(); // The buffer is reused for every line, as the tree copies each course it inserts
+    newCourse.courseNumber = nextField(remaining, endOfLine); // The course number is everything before the first comma
+    if (!endOfLine) {
+        newCourse.name = nextField(remaining, endOfLine); // The course name is everything before the second comma
+        while (!endOfLine) { // Every remaining field on the line is a prerequisite
+            string_view field = nextField(remaining, endOfLine);
+            if (!field.empty() && field != " ") { // If the prerequisite is not empty or blank
+                prerequisites.push_back(field); // Adds the prerequisite to the line's prerequisite buffer
+            }
+        }
+    }
+    newCourse.prerequisites.items = prerequisites.data();
+    newCourse.prerequisites.count = prerequisites.size();
+    int error = checkForFileFormatErrors(newCourse); // Checks for errors in the new course object
+    if (error != 0) { // If an error is found
+        return error; // Return the error code
+    }
+    return 0; // If no errors are found, the new course object is okay to be added to a node
+}
+
+enum DeltaOperation { // The changes a line of a delta file can make to the catalog
+    DELTA_ADD, // Adds a course that is not in the catalog
+    DELTA_MODIFY, // Replaces the name and prerequisites of a course in the catalog
+    DELTA_DELETE // Removes a course that no remaining course requires
+};
+
+int parseDeltaLine(string_view& remaining, DeltaOperation& operation, CourseObject& newCourse, vector<string_view>& prerequisites) { // Parses the next line of a delta file, an operation followed by a course line (or only a course number for a delete), and checks for file format errors
+    bool endOfLine = false;
+    newCourse = CourseObject();
+    prerequisites.clear();
+    string_view operationName = nextField(remaining, endOfLine);
+    auto named = [&operationName](string_view word) { return operationName.size() == word.size() && hasCoursePrefix(operationName, word); }; // Operations ignore case, like course numbers
+    if (named("ADD")) {
+        operation = DELTA_ADD;
+    }
+    else if (named("MODIFY")) {
+        operation = DELTA_MODIFY;
+    }
+    else if (named("DELETE")) {
+        operation = DELTA_DELETE;
+    }
+    else {
+        if (!endOfLine) {
+            nextLine(remaining); // Skip the rest of the line
+        }
+        return 6; // Error code for an unknown operation
+    }
+    if (operation == DELTA_DELETE || endOfLine) {
+        if (!endOfLine) {
+            newCourse.courseNumber = nextField(remaining, endOfLine);
+        }
+        if (!endOfLine) {
+            nextLine(remaining); // A delete may be written as a whole course line, but only its course number is needed
+        }
+        return newCourse.courseNumber.empty() ? 1 : 0;
+    }
+    return parseCourseLine(remaining, newCourse, prerequisites);
+}
+
+string formatHeaderRow(const string& line) { // Formats the first line of the provided file as the header row of the course listing
+    istringstream lineStream(line); // Create a string stream to process the extracted header line from the input file
+    string item; // Variable to parse info from extracted header line
+    vector<string> items; // Variable to store those items
+    while (getline(lineStream, item, ',')) { // Extracts using commas as delimiters
+        items.push_back(item); // Appends the items vector
+    }
+    items.resize(max<size_t>(items.size(), 2)); // A header without a name column still gets both columns
+    string row;
+    appendPadded(row, items[0], COURSE_NUMBER_COLUMN_WIDTH);
+    row += '|';
+    appendPadded(row, items[1], NAME_COLUMN_WIDTH);
+    row += '|';
+    for (size_t i = 2; i < items.size(); ++i) {
+        appendPadded(row, items[i], PREREQUISITE_COLUMN_WIDTH);
+        row += '|';
+    }
+    row += '\n';
+    return row;
+}
+
+template <typename Walk>
+void writeCourseListing(ostream& out, const Catalog& catalog, MetricOperation operation, Walk walk) { // Writes the header and then each course that walk passes to the function it is given, recording the time as the passed in operation
+    ScopedLatency timer(operation);
+    ListingBuffer listing(out);
+    listing.Append(catalog.headerRow);
+    walk([&listing](const CourseObject& courseObject) { listing.AppendCourse(courseObject); });
+}
+
+void displayAllCoursesAlphanumericOrder(shared_ptr<const Catalog> catalog) {
+    clock_t ticks = clock(); // Starting clock ticks for timing how long this function takes
+    if (catalog != nullptr) {
+        cout << "Courses Listed by Alphanumeric Order of Course Number:" << endl;
+        writeCourseListing(cout, *catalog, METRIC_TRAVERSE, [&catalog](auto appendCourse) { catalog->tree.ForEachInOrder(appendCourse); }); // Displays the header and each CourseObject by ascending alphanumeric order based on course numbers
+        cout << endl;
+    }
+    else {
+        cout << "There is no data in the binary search tree.\n" << endl; // If the BinarySearchTree has yet to have data added to it
+        return;
+    }
+    ticks = clock() - ticks; // End of function clock ticks minus starting clock ticks
+    cout << "time: " << ticks << " clock ticks" << endl; // Display elapsed time results
+    cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+    cout << "Displayed " << catalog->tree.Size() << " courses from the binary search tree.\n" << endl;
+}
+
+void displaySpecificCourse(shared_ptr<const Catalog> catalog) { // Displays information about a specific course based on user input
+    if (catalog != nullptr) { // Check if a catalog has been loaded
+        string courseNumber;
+        cout << "Enter a course number to search for: ";
+        getline(cin, courseNumber);
+        clock_t ticks = clock(); // Starting clock ticks
+        cout << endl;
+        const CourseObject* foundCourse = catalog->index.Find(courseNumber); // Calls the frozen index to find the course number (lowercase letters are upper-cased while it is packed into a key)
+        if (foundCourse != nullptr) { // If the search was successful, display associated course object information
+            cout << setw(15) << left << "Course Number: " << foundCourse->courseNumber << endl;
+            cout << "Name" << setw(11) << right << ": " << foundCourse->name << endl;
+            cout << setw(15) << left << "Prerequisites: ";
+            bool foundPrerequisites = false;
+            for (string_view prerequisite : foundCourse->prerequisites) {
+                if (foundPrerequisites == false) {
+                    cout << prerequisite;
+                    foundPrerequisites = true;
+                }
+                else {
+                    cout << ", " << prerequisite;
+                }
+            }
+            if (foundPrerequisites == false) {
+                cout << "None";
+            }
+            cout << endl << endl;
+        }
+        else {
+            cout << "Course Number: \"" << courseNumber << "\" was not found\n" << endl; // Else display that the user entered course was not found
+        }
+        ticks = clock() - ticks; // End of function clock ticks minus starting clock ticks
+        cout << "time: " << ticks << " clock ticks" << endl; // Display elapsed time results
+        cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+        cout << "Searched through " << nodesSearched << " of " << catalog->tree.Size() << " courses in the binary search tree.\n" << endl;
+    }
+    else {
+        cout << "There is no data in the binary search tree.\n" << endl; // If the BinarySearchTree has yet to have data added to it
+        return;
+    }
+}
+
+void displayCourseList(const PrerequisiteGraph& graph, const vector<int>& ids) { // Displays a comma-separated list of course numbers from their IDs, or "None"
+    if (ids.empty()) {
+        cout << "None";
+    }
+    for (size_t i = 0; i < ids.size(); ++i) {
+        cout << (i == 0 ? "" : ", ") << graph.Course(ids[i])->courseNumber;
+    }
+}
+
+void displayCoursePlan(shared_ptr<const Catalog> catalog) { // Displays every prerequisite of a course, a semester-by-semester plan for taking it, and what it unlocks
+    if (catalog != nullptr) { // Check if a catalog has been loaded
+        string courseNumber;
+        cout << "Enter a course number to plan for: ";
+        getline(cin, courseNumber);
+        clock_t ticks = clock(); // Starting clock ticks
+        cout << endl;
+        int id = catalog->graph.Id(courseNumber);
+        if (id >= 0) {
+            cout << setw(19) << left << "Course Number: " << catalog->graph.Course(id)->courseNumber << endl;
+            cout << setw(19) << left << "All Prerequisites: ";
+            displayCourseList(catalog->graph, catalog->graph.AllPrerequisites(id));
+            cout << endl << setw(19) << left << "Unlocks: ";
+            displayCourseList(catalog->graph, catalog->graph.Dependents(id, false));
+            cout << endl << "Semester Plan:" << endl;
+            vector<vector<int>> plan = catalog->graph.SemesterPlan(id);
+            for (size_t semester = 0; semester < plan.size(); ++semester) {
+                cout << "  Semester " << semester + 1 << ": ";
+                displayCourseList(catalog->graph, plan[semester]);
+                cout << endl;
+            }
+            cout << endl;
+        }
+        else {
+            cout << "Course Number: \"" << courseNumber << "\" was not found\n" << endl; // Else display that the user entered course was not found
+        }
+        ticks = clock() - ticks; // End of function clock ticks minus starting clock ticks
+        cout << "time: " << ticks << " clock ticks" << endl; // Display elapsed time results
+        cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds\n" << endl;
+    }
+    else {
+        cout << "There is no data in the binary search tree.\n" << endl; // If the BinarySearchTree has yet to have data added to it
+    }
+}
+
+void displayFileFormatError(int error, int lineCount) { // Displays the message for an error code found on a specific line of the input file
+    if (error == 1) {
+        cout << "Missing course number on line " << lineCount << " of the provided file.\n" << endl;
+    }
+    else if (error == 2) {
+        cout << "Missing course name on line " << lineCount << " of the provided file.\n" << endl;
+    }
+    else if (error == 3) {
+        cout << "The course on line " << lineCount << " has itself as a prerequisite.\n" << endl;
+    }
+    else if (error == 4) {
+        cout << "There was no available course matching the prerequisite\nfound on line " << lineCount << " of the provided file.\n" << endl;
+    }
+    else if (error == 5) {
+        cout << "The course number on line " << lineCount << " was already used on an earlier line.\n" << endl;
+    }
+    else if (error == 6) {
+        cout << "The change on line " << lineCount << " of the provided file is not ADD, MODIFY, or DELETE.\n" << endl;
+    }
+    else if (error == 7) {
+        cout << "There was no available course to change matching the course number\nfound on line " << lineCount << " of the provided file.\n" << endl;
+    }
+    else if (error == 8) {
+        cout << "The course added on line " << lineCount << " of the provided file is already loaded.\n" << endl;
+    }
+    else if (error == 9) {
+        cout << "The course deleted on line " << lineCount << " of the provided file is still\na prerequisite of another course.\n" << endl;
+    }
+    else {
+        cout << "An unknown error was found on line " << lineCount << " of the provided file." << endl; // Should not be called in the scope of this program
+    }
+}
+
+const size_t PARALLEL_CHUNK_BYTES = 1024 * 1024; // Each loading thread is given at least this much of the file, so small files are loaded by one thread
+
+struct ParsedCourse { // A course read from one line of the input file, along with where it came from and what was wrong with it
+    CourseObject course; // Views the mapped file, with prerequisites viewing its chunk's prerequisite buffer
+    CourseKey key; // The packed course number, so sorting rarely touches the text
+    int lineCount; // The line of the input file the course was read from
+    int error; // The first file format error found on the line, or 0
+    DeltaOperation operation = DELTA_ADD; // The change a line of a delta file makes, as every line of a catalog file adds its course
+};
+
+struct ParsedChunk { // A run of whole lines of the input file, parsed by one thread
+    string_view text;
+    vector<ParsedCourse> courses;
+    vector<string_view> prerequisites; // Every prerequisite in the chunk, each course viewing its own run of them
+    int lineCount; // Number of lines in the chunk
+};
+
+template <typename Work>
+void runInParallel(size_t taskCount, Work work) { // Runs work(0) up to work(taskCount - 1) at the same time, one per thread, and waits for all of them
+    vector<thread> workers;
+    for (size_t task = 1; task < taskCount; ++task) {
+        workers.emplace_back(work, task);
+    }
+    work(0); // The calling thread does the first task instead of waiting idle
+    for (thread& worker : workers) {
+        worker.join();
+    }
+}
+
+template <typename T, typename Compare>
+void parallelSort(vector<T>& items, size_t threadCount, Compare less) { // Sorts one run of items per thread concurrently, then merges pairs of runs concurrently until one run is left
+    size_t runCount = max<size_t>(1, min(threadCount, items.size()));
+    vector<size_t> bounds(runCount + 1); // Run i is items[bounds[i]] up to items[bounds[i + 1]]
+    for (size_t run = 0; run <= runCount; ++run) {
+        bounds[run] = items.size() * run / runCount;
+    }
+    runInParallel(runCount, [&](size_t run) {
+        sort(items.begin() + bounds[run], items.begin() + bounds[run + 1], less);
+    });
+    vector<T> merged(items.size());
+    while (bounds.size() > 2) {
+        size_t remainingRuns = bounds.size() - 1;
+        runInParallel((remainingRuns + 1) / 2, [&](size_t pair) {
+            size_t first = bounds[2 * pair], middle = bounds[min(2 * pair + 1, bounds.size() - 1)], last = bounds[min(2 * pair + 2, bounds.size() - 1)];
+            merge(make_move_iterator(items.begin() + first), make_move_iterator(items.begin() + middle), make_move_iterator(items.begin() + middle), make_move_iterator(items.begin() + last), merged.begin() + first, less); // An odd run at the end is merged with nothing, which moves it across unchanged
+        });
+        swap(items, merged);
+        vector<size_t> mergedBounds;
+        for (size_t i = 0; i < bounds.size(); i += 2) {
+            mergedBounds.push_back(bounds[i]);
+        }
+        if (mergedBounds.back() != items.size()) {
+            mergedBounds.push_back(items.size());
+        }
+        bounds = move(mergedBounds);
+    }
+}
+
+void parseChunk(ParsedChunk& chunk, bool deltaLines) { // Parses every line of a chunk, as course lines or as the lines of a delta file, and checks each one for the errors that can be found from its own line
+    vector<string_view> prerequisites; // Reused buffer for the prerequisites of the line being parsed
+    vector<size_t> prerequisiteStarts; // Where each course's prerequisites begin, as the buffer below may move while it grows
+    string_view remaining = chunk.text;
+    chunk.lineCount = 0;
+    while (!remaining.empty()) {
+        ParsedCourse parsed;
+        parsed.error = deltaLines ? parseDeltaLine(remaining, parsed.operation, parsed.course, prerequisites) : parseCourseLine(remaining, parsed.course, prerequisites);
+        parsed.key = makeCourseKey(parsed.course.courseNumber);
+        parsed.lineCount = chunk.lineCount++; // Counted from the start of the chunk until the lines before it are known
+        prerequisiteStarts.push_back(chunk.prerequisites.size());
+        chunk.prerequisites.insert(chunk.prerequisites.end(), prerequisites.begin(), prerequisites.end());
+        chunk.courses.push_back(parsed);
+    }
+    for (size_t i = 0; i < chunk.courses.size(); ++i) {
+        chunk.courses[i].course.prerequisites.items = chunk.prerequisites.data() + prerequisiteStarts[i];
+    }
+}
+
+bool parsedCourseBefore(const ParsedCourse& first, const ParsedCourse& second) { // Orders parsed courses by course number, and by line among equal course numbers
+    int comparison = compareCourseKeys(first.key, second.key);
+    return comparison != 0 ? comparison < 0 : first.lineCount < second.lineCount;
+}
+
+const ParsedCourse* findParsedCourse(const vector<ParsedCourse>& sortedCourses, string_view courseNumber) { // Returns the earliest line of the file with courseNumber, ignoring case, or nullptr if there is none
+    CourseKey key = makeCourseKey(courseNumber);
+    auto found = lower_bound(sortedCourses.begin(), sortedCourses.end(), key, [](const ParsedCourse& parsed, const CourseKey& searchKey) {
+        return compareCourseKeys(parsed.key, searchKey) < 0;
+    });
+    return found != sortedCourses.end() && compareCourseKeys(found->key, key) == 0 ? &*found : nullptr;
+}
+
+bool courseNumberExists(const vector<ParsedCourse>& sortedCourses, string_view courseNumber) { // Checks if any line of the file has courseNumber, ignoring case
+    return findParsedCourse(sortedCourses, courseNumber) != nullptr;
+}
+
+const char SNAPSHOT_MAGIC[8] = { 'A', 'B', 'C', 'U', 'S', 'N', 'A', 'P' }; // The first bytes of every snapshot file
+const uint32_t SNAPSHOT_VERSION = 1; // Changed whenever the layout below changes, so old snapshots are rejected rather than misread
+const uint32_t SNAPSHOT_BYTE_ORDER = 0x01020304; // Reads back differently on a machine of the other byte order
+
+struct SnapshotHeader { // Defining the start of a snapshot file, which locates every section; offsets are from the start of the file and 8-byte aligned
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint64_t fileSize;
+    uint64_t checksum; // Of every byte after the header
+    uint64_t courseCount;
+    uint64_t prerequisiteCount;
+    uint64_t stringBytes;
+    uint64_t recordsOffset; // courseCount SnapshotRecords, in alphanumeric order so a record's position is its course ID
+    uint64_t prerequisitesOffset; // prerequisiteCount course IDs, each record's run after the previous record's
+    uint64_t stringsOffset; // stringBytes of course numbers, names, and the file header, back to back
+    uint64_t indexKeysOffset; // courseCount + 1 packed keys in Eytzinger order
+    uint64_t indexIdsOffset; // courseCount + 1 course IDs in Eytzinger order
+    uint64_t fileHeaderOffset; // The first line of the original file, within the strings
+    uint64_t fileHeaderLength;
+};
+
+struct SnapshotRecord { // Defining one course in a snapshot, with its text as offsets into the strings
+    uint64_t numberOffset;
+    uint64_t nameOffset;
+    uint64_t firstPrerequisite; // Position of the course's first prerequisite ID
+    uint32_t numberLength;
+    uint32_t nameLength;
+    uint32_t prerequisiteCount;
+    uint32_t reserved;
+};
+
+static_assert(is_trivially_copyable<SnapshotHeader>::value && sizeof(SnapshotHeader) % 8 == 0, "SnapshotHeader is written and read as raw bytes");
+static_assert(is_trivially_copyable<SnapshotRecord>::value && sizeof(SnapshotRecord) % 8 == 0, "SnapshotRecord is written and read as raw bytes");
+
+uint64_t snapshotChecksum(const char* data, size_t size) { // FNV-1a over 8-byte words, which is fast enough to check a whole snapshot as it loads
+    uint64_t hash = 14695981039346656037ULL; // FNV-1a offset basis
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        memcpy(&word, data + i, 8);
+        hash = (hash ^ word) * 1099511628211ULL; // FNV-1a prime
+    }
+    for (; i < size; ++i) {
+        hash = (hash ^ static_cast<unsigned char>(data[i])) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+bool isSnapshot(string_view contents) { // Checks if a file starts like a snapshot rather than a CSV file
+    return contents.size() >= sizeof(SNAPSHOT_MAGIC) && memcmp(contents.data(), SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) == 0;
+}
+
+size_t alignSnapshotOffset(size_t offset) { // Rounds an offset up so the section starting there is 8-byte aligned
+    return (offset + 7) & ~static_cast<size_t>(7);
+}
+
+bool writeSnapshot(const Catalog& catalog, const string& filePath) { // Writes the catalog as a snapshot that loads without parsing, returning false if the file could not be written
+    const CatalogIndex& index = catalog.index;
+    size_t count = static_cast<size_t>(index.Size());
+    vector<SnapshotRecord> records(count);
+    vector<uint32_t> prerequisiteIds;
+    string strings;
+    for (size_t id = 0; id < count; ++id) { // Courses are written in ID order, each with its prerequisites as IDs
+        const CourseObject* course = index.CourseAt(static_cast<int>(id));
+        SnapshotRecord& record = records[id];
+        record.numberOffset = strings.size();
+        record.numberLength = static_cast<uint32_t>(course->courseNumber.size());
+        strings.append(course->courseNumber.data(), course->courseNumber.size());
+        record.nameOffset = strings.size();
+        record.nameLength = static_cast<uint32_t>(course->name.size());
+        strings.append(course->name.data(), course->name.size());
+        record.firstPrerequisite = prerequisiteIds.size();
+        record.prerequisiteCount = static_cast<uint32_t>(catalog.graph.PrerequisiteCount(static_cast<int>(id)));
+        record.reserved = 0;
+        for (uint32_t i = 0; i < record.prerequisiteCount; ++i) {
+            prerequisiteIds.push_back(static_cast<uint32_t>(catalog.graph.PrerequisiteId(static_cast<int>(id), static_cast<int>(i))));
+        }
+    }
+    SnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    header.version = SNAPSHOT_VERSION;
+    header.byteOrder = SNAPSHOT_BYTE_ORDER;
+    header.courseCount = count;
+    header.prerequisiteCount = prerequisiteIds.size();
+    header.fileHeaderOffset = strings.size();
+    header.fileHeaderLength = catalog.fileHeader.size();
+    strings += catalog.fileHeader;
+    header.stringBytes = strings.size();
+    vector<uint64_t> indexKeys;
+    vector<int32_t> indexIds;
+    index.Export(indexKeys, indexIds);
+    header.recordsOffset = sizeof(SnapshotHeader);
+    header.prerequisitesOffset = alignSnapshotOffset(header.recordsOffset + records.size() * sizeof(SnapshotRecord));
+    header.stringsOffset = alignSnapshotOffset(header.prerequisitesOffset + prerequisiteIds.size() * sizeof(uint32_t));
+    header.indexKeysOffset = alignSnapshotOffset(header.stringsOffset + strings.size());
+    header.indexIdsOffset = alignSnapshotOffset(header.indexKeysOffset + indexKeys.size() * sizeof(uint64_t));
+    header.fileSize = alignSnapshotOffset(header.indexIdsOffset + indexIds.size() * sizeof(int32_t));
+    string body(header.fileSize - sizeof(SnapshotHeader), '\0'); // Everything after the header, padding included, so the checksum covers it all
+    auto place = [&body](uint64_t offset, const void* bytes, size_t size) {
+        if (size != 0) {
+            memcpy(&body[offset - sizeof(SnapshotHeader)], bytes, size);
+        }
+    };
+    place(header.recordsOffset, records.data(), records.size() * sizeof(SnapshotRecord));
+    place(header.prerequisitesOffset, prerequisiteIds.data(), prerequisiteIds.size() * sizeof(uint32_t));
+    place(header.stringsOffset, strings.data(), strings.size());
+    place(header.indexKeysOffset, indexKeys.data(), indexKeys.size() * sizeof(uint64_t));
+    place(header.indexIdsOffset, indexIds.data(), indexIds.size() * sizeof(int32_t));
+    header.checksum = snapshotChecksum(body.data(), body.size());
+    ofstream file(filePath, ios::binary | ios::trunc);
+    if (!file.is_open()) {
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(body.data(), static_cast<streamsize>(body.size()));
+    return static_cast<bool>(file);
+}
+
+int importSnapshot(Catalog& catalog, MappedSource& source) { // Builds a catalog from the snapshot mapped in source, viewing the snapshot's text in place, returning 0 or a snapshot error code
+    string_view contents = source.file.Contents();
+    if (contents.size() < sizeof(SnapshotHeader)) {
+        return 2; // Error code for a snapshot that is cut short
+    }
+    SnapshotHeader header;
+    memcpy(&header, contents.data(), sizeof(header));
+    if (header.version != SNAPSHOT_VERSION || header.byteOrder != SNAPSHOT_BYTE_ORDER) {
+        return 1; // Error code for a snapshot written by a different version or on a different kind of machine
+    }
+    uint64_t count = header.courseCount;
+    auto fits = [&header](uint64_t offset, uint64_t items, uint64_t itemSize) { // Checks that a section lies inside the file, without overflowing
+        return offset % 8 == 0 && offset >= sizeof(SnapshotHeader) && offset <= header.fileSize && items <= (header.fileSize - offset) / itemSize;
+    };
+    if (header.fileSize != contents.size() || count >= static_cast<uint64_t>(INT32_MAX) || !fits(header.recordsOffset, count, sizeof(SnapshotRecord))
+        || !fits(header.prerequisitesOffset, header.prerequisiteCount, sizeof(uint32_t)) || !fits(header.stringsOffset, header.stringBytes, 1)
+        || !fits(header.indexKeysOffset, count + 1, sizeof(uint64_t)) || !fits(header.indexIdsOffset, count + 1, sizeof(int32_t))
+        || header.fileHeaderOffset > header.stringBytes || header.fileHeaderLength > header.stringBytes - header.fileHeaderOffset) {
+        return 2;
+    }
+    if (snapshotChecksum(contents.data() + sizeof(SnapshotHeader), contents.size() - sizeof(SnapshotHeader)) != header.checksum) {
+        return 3; // Error code for a snapshot whose contents do not match its checksum
+    }
+    const SnapshotRecord* records = reinterpret_cast<const SnapshotRecord*>(contents.data() + header.recordsOffset); // Sections are aligned, so they are used where they are mapped
+    const uint32_t* prerequisiteIds = reinterpret_cast<const uint32_t*>(contents.data() + header.prerequisitesOffset);
+    const char* strings = contents.data() + header.stringsOffset;
+    vector<CourseObject> courses(count);
+    vector<int> firstPrerequisites(count + 1, 0);
+    vector<int> prerequisiteList(prerequisiteIds, prerequisiteIds + header.prerequisiteCount);
+    CourseKey previousKey = {};
+    for (uint64_t id = 0; id < count; ++id) { // Course text is viewed in place, so only the views need setting up
+        const SnapshotRecord& record = records[id];
+        if (record.numberOffset > header.stringBytes || record.numberLength > header.stringBytes - record.numberOffset || record.nameOffset > header.stringBytes
+            || record.nameLength > header.stringBytes - record.nameOffset || record.firstPrerequisite != static_cast<uint64_t>(firstPrerequisites[id])
+            || record.prerequisiteCount > header.prerequisiteCount - record.firstPrerequisite) {
+            return 2;
+        }
+        courses[id].courseNumber = string_view(strings + record.numberOffset, record.numberLength);
+        CourseKey key = makeCourseKey(courses[id].courseNumber);
+        if (id > 0 && compareCourseKeys(previousKey, key) >= 0) { // The checksum only catches accidental damage, and a tree built from courses out of order or repeated would answer searches wrongly
+            return 2;
+        }
+        previousKey = key;
+        courses[id].name = string_view(strings + record.nameOffset, record.nameLength);
+        firstPrerequisites[id + 1] = static_cast<int>(record.firstPrerequisite + record.prerequisiteCount);
+    }
+    if (static_cast<uint64_t>(firstPrerequisites[count]) != header.prerequisiteCount) {
+        return 2;
+    }
+    source.snapshotPrerequisites.resize(header.prerequisiteCount);
+    for (uint64_t i = 0; i < header.prerequisiteCount; ++i) { // Prerequisites view the course numbers of the courses they name, as the tree's interned strings would
+        if (prerequisiteIds[i] >= count) {
+            return 2;
+        }
+        source.snapshotPrerequisites[i] = courses[prerequisiteIds[i]].courseNumber;
+    }
+    for (uint64_t id = 0; id < count; ++id) {
+        courses[id].prerequisites.items = source.snapshotPrerequisites.data() + firstPrerequisites[id];
+        courses[id].prerequisites.count = static_cast<size_t>(firstPrerequisites[id + 1] - firstPrerequisites[id]);
+    }
+    catalog.fileHeader = string(strings + header.fileHeaderOffset, header.fileHeaderLength);
+    catalog.headerRow = formatHeaderRow(catalog.fileHeader);
+    catalog.tree.BuildFromSorted(courses, false); // The snapshot stays mapped for as long as any catalog's tree views it, so its text is not copied
+    if (!catalog.index.Import(reinterpret_cast<const uint64_t*>(contents.data() + header.indexKeysOffset), reinterpret_cast<const int32_t*>(contents.data() + header.indexIdsOffset), catalog.tree)) {
+        return 2;
+    }
+    vector<int> cycle;
+    if (!catalog.graph.Import(catalog.index, move(firstPrerequisites), move(prerequisiteList), cycle)) { // Snapshots are only written for catalogs without cycles
+        return 2;
+    }
+    return 0;
+}
+
+void displaySnapshotError(int error) { // Displays the message for an error code found while loading a snapshot
+    if (error == 1) {
+        cout << "The snapshot was written by a different version of this program.\n" << endl;
+    }
+    else if (error == 2) {
+        cout << "The snapshot is incomplete, or its contents are out of range or out of order.\n" << endl;
+    }
+    else if (error == 3) {
+        cout << "The snapshot's contents do not match its checksum.\n" << endl;
+    }
+    else {
+        cout << "An unknown error was found in the snapshot." << endl; // Should not be called in the scope of this program
+    }
+}
+
+void displayPrerequisiteCycle(const CatalogIndex& catalogIndex, const vector<int>& cycle) { // Displays the courses of a prerequisite cycle as a chain of requirements
+    cout << "The prerequisites of course " << catalogIndex.CourseAt(cycle[0])->courseNumber << " form a cycle:\n";
+    for (size_t i = 0; i < cycle.size(); ++i) {
+        cout << (i == 0 ? "" : " requires ") << catalogIndex.CourseAt(cycle[i])->courseNumber;
+    }
+    cout << "\n" << endl;
+}
+
+shared_ptr<const Catalog> loadCatalog(const string& filePath) { // Loads the file at filePath into a new catalog without touching the published one, returning nullptr if it could not be loaded
+    clock_t ticks = clock(); // Starting clock ticks
+    ScopedLatency loadTimer(METRIC_LOAD);
+    auto catalog = make_shared<Catalog>(); // Only this function can see the new catalog until it is returned
+    auto source = make_shared<MappedSource>(); // Only kept once loading is done if the file is a snapshot
+    MappedFile& inputFile = source->file; // Maps the file into memory so it can be parsed in place
+    if (!inputFile.Open(filePath)) { // If the file at the given filePath was NOT successfully opened
+        cout << "\nFailed to open the file at \"" << filePath << "\".\n" << endl;
+        return nullptr;
+    }
+    cout << "\nSuccessfully opened the file at \"" << filePath << "\".\n" << endl;
+    string_view remaining = inputFile.Contents(); // The part of the file that has not been parsed yet
+    if (isSnapshot(remaining)) { // A snapshot is already validated and sorted, so it is mapped in place instead of parsed
+        inputFile.AdviseRandomAccess(); // Every course found later reads its text from the mapping
+        int error = importSnapshot(*catalog, *source);
+        if (error != 0) {
+            displaySnapshotError(error);
+            return nullptr;
+        }
+        catalog->snapshot = move(source);
+        loadTimer.Stop();
+        ticks = clock() - ticks; // End of function clock ticks minus starting clock ticks
+        cout << "time: " << ticks << " clock ticks" << endl; // Display elapsed time results
+        cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+        cout << "Loaded " << catalog->tree.Size() << " courses into the binary search tree.\n" << endl;
+        return catalog;
+    }
+    catalog->fileHeader = string(nextLine(remaining)); // This assumes the first line of the CSV is a descriptive header, and does not include it in the array
+    catalog->headerRow = formatHeaderRow(catalog->fileHeader);
+    ScopedLatency parseTimer(METRIC_PARSE);
+    size_t threadCount = max<size_t>(1, min<size_t>(thread::hardware_concurrency(), remaining.size() / PARALLEL_CHUNK_BYTES));
+    vector<ParsedChunk> chunks(threadCount);
+    size_t chunkStart = 0;
+    for (size_t i = 0; i < threadCount; ++i) { // Split the file into roughly equal chunks that each end just after a line break
+        size_t chunkEnd = i + 1 == threadCount ? remaining.size() : max(chunkStart, remaining.size() * (i + 1) / threadCount);
+        if (chunkEnd < remaining.size()) {
+            const void* lineEnd = memchr(remaining.data() + chunkEnd, '\n', remaining.size() - chunkEnd);
+            chunkEnd = lineEnd == nullptr ? remaining.size() : static_cast<size_t>(static_cast<const char*>(lineEnd) - remaining.data()) + 1;
+        }
+        chunks[i].text = remaining.substr(chunkStart, chunkEnd - chunkStart);
+        chunkStart = chunkEnd;
+    }
+    runInParallel(threadCount, [&chunks](size_t i) { parseChunk(chunks[i], false); });
+    parseTimer.Stop();
+    ScopedLatency validateTimer(METRIC_VALIDATE);
+    vector<size_t> courseStarts(threadCount + 1, 0); // Where each chunk's courses go in the combined list
+    vector<int> firstLines(threadCount); // The line of the input file each chunk starts on
+    int lineCount = 2; // Excludes the header so that errors may be pinpointed to specific lines of the input file
+    for (size_t i = 0; i < threadCount; ++i) {
+        courseStarts[i + 1] = courseStarts[i] + chunks[i].courses.size();
+        firstLines[i] = lineCount;
+        lineCount += chunks[i].lineCount;
+    }
+    vector<ParsedCourse> parsedCourses(courseStarts[threadCount]);
+    runInParallel(threadCount, [&](size_t i) {
+        for (size_t j = 0; j < chunks[i].courses.size(); ++j) {
+            ParsedCourse& parsed = parsedCourses[courseStarts[i] + j];
+            parsed = chunks[i].courses[j];
+            parsed.lineCount += firstLines[i];
+        }
+    });
+    parallelSort(parsedCourses, threadCount, parsedCourseBefore);
+    vector<int> firstErrors(threadCount, 0), firstErrorLines(threadCount, lineCount); // The earliest error each thread found, as the first error in the file is the one reported
+    runInParallel(threadCount, [&](size_t i) {
+        size_t first = parsedCourses.size() * i / threadCount, last = parsedCourses.size() * (i + 1) / threadCount;
+        for (size_t j = first; j < last; ++j) {
+            ParsedCourse& parsed = parsedCourses[j];
+            if (parsed.error == 0 && j > 0 && compareCourseKeys(parsed.key, parsedCourses[j - 1].key) == 0) { // Equal course numbers are next to each other, earliest line first
+                parsed.error = 5; // Error code for a course number that appears more than once
+            }
+            for (size_t k = 0; parsed.error == 0 && k < parsed.course.prerequisites.size(); ++k) { // Every course number in the file is known, so prerequisites can be resolved wherever they appear
+                if (!courseNumberExists(parsedCourses, parsed.course.prerequisites.items[k])) {
+                    parsed.error = 4; // Error code for a prerequisite that is not a course in the file
+                }
+            }
+            if (parsed.error != 0 && parsed.lineCount < firstErrorLines[i]) {
+                firstErrors[i] = parsed.error;
+                firstErrorLines[i] = parsed.lineCount;
+            }
+        }
+    });
+    int errorCode = 0, errorLine = lineCount; // The first error found in the file, if any
+    for (size_t i = 0; i < threadCount; ++i) {
+        if (firstErrors[i] != 0 && firstErrorLines[i] < errorLine) {
+            errorCode = firstErrors[i];
+            errorLine = firstErrorLines[i];
+        }
     }
-
-    BSTNode(CourseObject aCourseObject) : BSTNode() { // Initialize a BSTNode with a courseObject
-        courseObject = aCourseObject;
+    validateTimer.Stop();
+    if (errorCode != 0) { // If an error is found, the new catalog is freed and the published one is left as it was
+        displayFileFormatError(errorCode, errorLine);
+        return nullptr; // Exits the function as an error was found in the file format
     }
-};
+    ScopedLatency insertTimer(METRIC_INSERT);
+    vector<CourseObject> sortedCourses(parsedCourses.size());
+    for (size_t i = 0; i < parsedCourses.size(); ++i) {
+        sortedCourses[i] = parsedCourses[i].course;
+    }
+    catalog->tree.BuildFromSorted(sortedCourses, true); // The tree copies every course's text into its own arena
+    insertTimer.Stop();
+    inputFile.Close(); // Releases the mapped input file once nothing views it any more
+    catalog->index.Build(catalog->tree); // The loaded courses will only be read from now on, so freeze them into a search index
+    vector<int> cycle;
+    if (!catalog->graph.Build(catalog->index, cycle)) { // A cycle would make it impossible to ever take the courses in it
+        displayPrerequisiteCycle(catalog->index, cycle);
+        return nullptr;
+    }
+    ticks = clock() - ticks; // End of function clock ticks minus starting clock ticks
+    cout << "time: " << ticks << " clock ticks" << endl; // Display elapsed time results
+    cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+    loadTimer.Stop(); // Stopped before the result is displayed, so console output is not timed
+    cout << "Loaded " << catalog->tree.Size() << " courses into the binary search tree.\n" << endl;
+    return catalog;
+}
 
-class BinarySearchTree { // Defining the functions and variables of a BinarySearchTree to be used in this program 
-private:
-    BSTNode* root;
-    void addNode(BSTNode* node, CourseObject courseObject);
-    void destroyTree(BSTNode* node);
-    void inOrder(BSTNode* node);
-    BSTNode* removeNode(BSTNode* node, string courseNumber);
-    BSTNode* findMin(BSTNode* node);
-    int Size(BSTNode* node);
+void processRequestedFile(const string& filePath) { // Loads the file at filePath and, if it loaded without errors, publishes it in place of the current catalog
+    shared_ptr<const Catalog> catalog = loadCatalog(filePath);
+    if (catalog != nullptr) { // A failed load leaves the current catalog in use
+        lock_guard<mutex> lock(catalogUpdateMutex);
+        publishCatalog(move(catalog));
+    }
+}
 
-public:
-    BinarySearchTree();
-    virtual ~BinarySearchTree();
-    int Size();
-    void InOrder();
-    void Insert(CourseObject courseObject);
-    void Remove(string courseNumber);
-    CourseObject Search(string courseNumber);
-};
+int validateDeltaChanges(const Catalog& catalog, vector<ParsedCourse>& changes, int& errorLine) { // Checks sorted delta changes against the catalog, looking only at the changed courses and the courses that require them, and returning the first error code and its line
+    auto existsAfterChanges = [&](string_view courseNumber) { // Checks if a course will be in the catalog once every change is made
+        const ParsedCourse* change = findParsedCourse(changes, courseNumber);
+        return change != nullptr ? change->operation != DELTA_DELETE : catalog.index.FindId(courseNumber) >= 0;
+    };
+    int errorCode = 0;
+    errorLine = 0;
+    for (size_t i = 0; i < changes.size(); ++i) {
+        ParsedCourse& change = changes[i];
+        if (change.error == 0 && i > 0 && compareCourseKeys(change.key, changes[i - 1].key) == 0) { // Equal course numbers are next to each other, earliest line first
+            change.error = 5; // Error code for a course number that is changed more than once
+        }
+        int id = change.error == 0 ? catalog.index.FindId(change.course.courseNumber) : -1;
+        if (change.error == 0 && change.operation == DELTA_ADD && id >= 0) {
+            change.error = 8; // Error code for adding a course that is already loaded
+        }
+        else if (change.error == 0 && change.operation != DELTA_ADD && id < 0) {
+            change.error = 7; // Error code for changing a course that is not loaded
+        }
+        for (size_t k = 0; change.error == 0 && k < change.course.prerequisites.size(); ++k) {
+            if (!existsAfterChanges(change.course.prerequisites.items[k])) {
+                change.error = 4; // Error code for a prerequisite that will not be a course in the catalog
+            }
+        }
+        if (change.error == 0 && change.operation == DELTA_DELETE) { // The reverse prerequisite index lists exactly the courses that must also be deleted or stop requiring this one
+            for (int dependent : catalog.graph.Dependents(id, false)) {
+                const ParsedCourse* dependentChange = findParsedCourse(changes, catalog.index.CourseAt(dependent)->courseNumber);
+                bool stillRequired = dependentChange == nullptr || (dependentChange->operation == DELTA_MODIFY
+                    && any_of(dependentChange->course.prerequisites.begin(), dependentChange->course.prerequisites.end(), [&change](string_view prerequisite) {
+                        return compareCourseKeys(makeCourseKey(prerequisite), change.key) == 0;
+                    }));
+                if (stillRequired) {
+                    change.error = 9; // Error code for deleting a course that another course still requires
+                    break;
+                }
+            }
+        }
+        if (change.error == 0 && change.operation != DELTA_ADD) {
+            change.course.courseNumber = catalog.index.CourseAt(id)->courseNumber; // A modified course keeps the course number as it was loaded, which its prerequisites elsewhere are spelled as
+        }
+        if (change.error != 0 && (errorCode == 0 || change.lineCount < errorLine)) {
+            errorCode = change.error;
+            errorLine = change.lineCount;
+        }
+    }
+    return errorCode;
+}
 
-//============================================================================
-// Global variables accessible by all functions
-//============================================================================
-BinarySearchTree* bst; // Define a BinarySearchTree to hold all course objects
-string fileHeader; // Stores the first line of the file as a header to be used while printing but not stored in the BinarySearchTree
-vector<string> allCourseNumbers; // Stores a list of all course numbers so that prerequisite errors may be found
-clock_t ticks; // To measure the time of each specified function
-int nodesSearched; // Keep track of amount of nodes searched
-
-void displayCourse(CourseObject courseObject) { // Display individual CourseObject information to the console
-    cout << setw(10) << left << courseObject.courseNumber << "|" << setw(35) << left << courseObject.name << "|";
-    if (!courseObject.prerequisites.empty()) { // Displays any prerequisites held by the CourseObject
-        bool firstPrerequisite = true;
-        for (const string& prerequisite : courseObject.prerequisites) {
-            if (!firstPrerequisite) {
-                cout << "|";
+shared_ptr<const Catalog> applyDeltaFile(shared_ptr<const Catalog> current, const string& filePath) { // Applies the delta file at filePath to a new copy of the current catalog, returning nullptr without changing anything if the file could not be read or any change is invalid
+    clock_t ticks = clock(); // Starting clock ticks
+    ScopedLatency applyTimer(METRIC_APPLY);
+    MappedFile deltaFile;
+    if (!deltaFile.Open(filePath)) {
+        cout << "\nFailed to open the file at \"" << filePath << "\".\n" << endl;
+        return nullptr;
+    }
+    cout << "\nSuccessfully opened the file at \"" << filePath << "\".\n" << endl;
+    ParsedChunk chunk; // Delta files are small, so they are parsed by one thread
+    chunk.text = deltaFile.Contents();
+    nextLine(chunk.text); // The first line is a descriptive header, as in a catalog file
+    parseChunk(chunk, true);
+    vector<ParsedCourse>& changes = chunk.courses;
+    for (ParsedCourse& change : changes) {
+        change.lineCount += 2; // Excludes the header so that errors may be pinpointed to specific lines of the input file
+    }
+    sort(changes.begin(), changes.end(), parsedCourseBefore);
+    const Catalog& base = *current;
+    int errorLine;
+    int errorCode = validateDeltaChanges(base, changes, errorLine);
+    if (errorCode != 0) { // If an error is found, the published catalog is left as it was
+        displayFileFormatError(errorCode, errorLine);
+        return nullptr;
+    }
+    auto catalog = make_shared<Catalog>();
+    catalog->fileHeader = base.fileHeader;
+    catalog->headerRow = base.headerRow;
+    catalog->tree.ShareNodes(base.tree); // Only the paths to the changed courses are copied, so the published tree is never changed
+    for (ParsedCourse& change : changes) {
+        if (change.operation != DELTA_ADD) {
+            catalog->tree.Remove(change.course.courseNumber);
+        }
+        if (change.operation != DELTA_DELETE) {
+            catalog->tree.Insert(move(change.course)); // The course's text is copied out of the delta file
+        }
+    }
+    int oldCount = base.index.Size(), newCount = catalog->tree.Size();
+    vector<int> oldIds(newCount, -1); // The old ID of each new ID, or -1 for a course this delta added or modified
+    vector<int> newIds(oldCount, -1); // The new ID of each old ID, or -1 for a deleted course
+    size_t nextChange = 0;
+    int newId = 0;
+    for (int id = 0; id < oldCount; ++id) { // Both catalogs are in alphanumeric order, so one merge with the sorted changes pairs up their IDs
+        CourseKey oldKey = makeCourseKey(base.index.CourseAt(id)->courseNumber);
+        for (; nextChange < changes.size() && compareCourseKeys(changes[nextChange].key, oldKey) < 0; ++nextChange) { // Only an added course is not already in the catalog
+            newId++;
+        }
+        if (nextChange < changes.size() && compareCourseKeys(changes[nextChange].key, oldKey) == 0) {
+            if (changes[nextChange++].operation == DELTA_MODIFY) { // A modified course keeps the courses that require it
+                newIds[id] = newId++;
+            }
+            continue;
+        }
+        newIds[id] = newId;
+        oldIds[newId++] = id;
+    }
+    vector<int> firstPrerequisites(newCount + 1, 0), prerequisiteList;
+    for (int id = 0; id < newCount; ++id) { // Unchanged courses renumber their old prerequisite IDs instead of searching for each prerequisite again
+        if (oldIds[id] >= 0) {
+            for (int i = 0; i < base.graph.PrerequisiteCount(oldIds[id]); ++i) {
+                prerequisiteList.push_back(newIds[base.graph.PrerequisiteId(oldIds[id], i)]); // Validation made sure no prerequisite of an unchanged course is deleted
             }
-            cout << setw(14) << left << prerequisite;
-            firstPrerequisite = false;
         }
+        else { // A changed course's prerequisites are found by their positions in the changed tree, before there is an index
+            for (string_view prerequisite : catalog->tree.Select(id)->prerequisites) {
+                prerequisiteList.push_back(catalog->tree.Rank(prerequisite));
+            }
+        }
+        firstPrerequisites[id + 1] = static_cast<int>(prerequisiteList.size());
+    }
+    if (catalog->tree.NeedsCompaction()) { // Rare, as it takes changes worth a whole catalog to pile up, so the O(n) copy is spread over many deltas
+        catalog->tree.Compact(firstPrerequisites, prerequisiteList); // The courses stop viewing the snapshot, if there was one
     }
     else {
-        cout << setw(14) << left << "None";
+        catalog->snapshot = base.snapshot; // Unchanged courses loaded from a snapshot still view its text
     }
-    cout << endl;
-}
-
-BinarySearchTree::BinarySearchTree() { // Default constructor for a BinarySearchTree (Public)
-    root = nullptr; // Initialize the root of the BinarySearchTree as nullptr
+    catalog->index.Build(catalog->tree);
+    vector<int> cycle;
+    if (!catalog->graph.Import(catalog->index, move(firstPrerequisites), move(prerequisiteList), cycle)) { // A changed prerequisite may close a cycle through courses the delta did not touch
+        displayPrerequisiteCycle(catalog->index, cycle);
+        return nullptr;
+    }
+    ticks = clock() - ticks; // End of function clock ticks minus starting clock ticks
+    cout << "time: " << ticks << " clock ticks" << endl; // Display elapsed time results
+    cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+    applyTimer.Stop(); // Stopped before the result is displayed, so console output is not timed
+    cout << "Applied " << changes.size() << " changes, leaving " << catalog->tree.Size() << " courses in the binary search tree.\n" << endl;
+    return catalog;
 }
 
-BinarySearchTree::~BinarySearchTree() { // Destructor for a BinarySearchTree used when delete is called (Public)
-    destroyTree(root); // Call the function to recursively destroy the entire BinarySearchTree
+void processDeltaFile(const string& filePath) { // Applies the delta file at filePath to the current catalog and, if every change was valid, publishes the changed catalog in its place
+    lock_guard<mutex> lock(catalogUpdateMutex); // Held until the changed catalog is published, so a catalog loaded meanwhile is not overwritten by a delta applied to the one before it
+    shared_ptr<const Catalog> catalog = currentCatalog();
+    if (catalog == nullptr) {
+        cout << "There is no data in the binary search tree.\n" << endl; // A delta file can only change courses that have been loaded
+        return;
+    }
+    catalog = applyDeltaFile(move(catalog), filePath);
+    if (catalog != nullptr) { // A failed delta leaves the current catalog in use
+        publishCatalog(move(catalog));
+    }
 }
 
-int BinarySearchTree::Size() { // Returns the size of a BinarySearchTree (Public)
-    return Size(root); // Call the function to calculate the size of the BinarySearchTree starting from the root
+size_t catalogMemoryBytes(const Catalog& catalog) { // Returns the bytes a catalog holds outside the arenas, which the operation metrics already count
+    size_t snapshotBytes = catalog.snapshot != nullptr ? catalog.snapshot->file.Contents().size() + catalog.snapshot->snapshotPrerequisites.capacity() * sizeof(string_view) : 0;
+    return snapshotBytes + catalog.index.MemoryBytes() + catalog.graph.MemoryBytes()
+        + catalog.fileHeader.capacity() + catalog.headerRow.capacity();
 }
 
-int BinarySearchTree::Size(BSTNode* node) { // Recursively returns the size of a BinarySearchTree  (Private)
-    if (node == nullptr) { // If the current node is nullptr (empty), return 0
-        return 0;
+void writeStatistics(ostream& out, shared_ptr<const Catalog> catalog) { // Writes the operation metrics and the shape of the current catalog's tree as JSON
+    out << "{\n  \"catalog\":";
+    if (catalog != nullptr) {
+        int courses = catalog->tree.Size(), minimumHeight = 0;
+        while ((1LL << minimumHeight) - 1 < courses) { // A perfectly balanced tree of this many courses has this many levels
+            minimumHeight++;
+        }
+        out << "{\"courses\":" << courses << ",\"treeHeight\":" << catalog->tree.Height() << ",\"minimumHeight\":" << minimumHeight << "}";
     }
-    return 1 + Size(node->left) + Size(node->right); // Recursively calculate the size of the tree by counting all children starting at the root
-}
-
-void BinarySearchTree::InOrder() { // Traverse the BinarySearchTree in order (Public)
-    inOrder(root); // Call the function for in-order traversal of the BinarySearchTree starting from the root
+    else {
+        out << "null";
+    }
+    out << ",\n  ";
+    metrics.WriteJson(out, catalog != nullptr ? catalogMemoryBytes(*catalog) : 0);
+    out << "\n}" << endl;
 }
 
-void BinarySearchTree::inOrder(BSTNode* node) { // Recursively call the function for in-order traversal of the BinarySearchTree starting from the root
-    if (node != nullptr) {
-        inOrder(node->left); // Recursively traverse the left subtree
-        displayCourse(node->courseObject); // Display the courseObject at the passed in node
-        inOrder(node->right); // Recursively traverse the right subtree
+string_view trimQuery(string_view query) { // Removes the surrounding whitespace (including a Windows line ending) from a query
+    size_t first = query.find_first_not_of(" \t\r");
+    if (first == string_view::npos) {
+        return string_view();
     }
+    return query.substr(first, query.find_last_not_of(" \t\r") - first + 1);
 }
 
-void BinarySearchTree::Insert(CourseObject courseObject) { // Insert a CourseObject into the BinarySearchTree (Public)
-    if (root == nullptr) { // If the tree is empty, create a new root node with the passed in courseObject
-        root = new BSTNode(courseObject);
+void displayCourseRange(shared_ptr<const Catalog> catalog) { // Displays every course whose course number starts with a prefix, or falls in a range, based on user input
+    if (catalog != nullptr) { // Check if a catalog has been loaded
+        string query;
+        cout << "Enter a course number prefix (e.g., MATH) or a range (e.g., CSCI200,CSCI299): ";
+        getline(cin, query);
+        clock_t ticks = clock(); // Starting clock ticks
+        cout << endl;
+        size_t comma = query.find(','); // Commas separate the fields of the input file, so unlike dashes they never appear in a course number
+        string_view low = trimQuery(string_view(query).substr(0, comma)), high;
+        if (comma != string::npos) {
+            high = trimQuery(string_view(query).substr(comma + 1));
+            if (low.empty() || high.empty() || high.find(',') != string_view::npos) {
+                cout << "A range needs one first and one last course number, separated by a comma (e.g., CSCI200,CSCI299).\n" << endl;
+                return;
+            }
+        }
+        int found = 0;
+        {
+            ScopedLatency timer(METRIC_RANGE);
+            ListingBuffer listing(cout);
+            auto appendCourse = [&](const CourseObject& courseObject) { // The title and header are only written once there is a course to show
+                if (found++ == 0) {
+                    listing.Append("Courses Matching \"" + query + "\":\n");
+                    listing.Append(catalog->headerRow);
+                }
+                listing.AppendCourse(courseObject);
+            };
+            if (comma != string::npos) { // A range includes both of its ends
+                catalog->tree.ForEachInRange(low, high, appendCourse); // Only the matching courses are visited
+            }
+            else {
+                catalog->tree.ForEachWithPrefix(low, appendCourse);
+            }
+        }
+        if (found > 0) {
+            cout << endl;
+        }
+        else {
+            cout << "No courses matching \"" << query << "\" were found\n" << endl;
+        }
+        ticks = clock() - ticks; // End of function clock ticks minus starting clock ticks
+        cout << "time: " << ticks << " clock ticks" << endl; // Display elapsed time results
+        cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+        cout << "Found " << found << " of " << catalog->tree.Size() << " courses in the binary search tree.\n" << endl;
     }
     else {
-        addNode(root, courseObject); // Otherwise, call a function to recursively add the courseObject as a node to the tree
+        cout << "There is no data in the binary search tree.\n" << endl; // If the BinarySearchTree has yet to have data added to it
     }
 }
 
-void BinarySearchTree::Remove(string courseNumber) { // Remove a courseObject from the BinarySearchTree (Public)
-    root = removeNode(root, courseNumber); // Call a function to remove the node with the passed in courseNumber from the BinarySearchTree
+void displayStatistics() { // Displays the operation metrics as JSON
+    writeStatistics(cout, currentCatalog());
+    cout << endl;
 }
 
-CourseObject BinarySearchTree::Search(string courseNumber) { // Search for a courseObject
-    BSTNode* currentNode = root; // Start the search from the root of the tree
-    nodesSearched = 0;
-    while (currentNode != nullptr) {
-        if (currentNode->courseObject.courseNumber == courseNumber) { // If the courseNumber matches, return the found courseObject
-            nodesSearched++;
-            return currentNode->courseObject;
-        }
-        else if (courseNumber < currentNode->courseObject.courseNumber) { // Move to the left subtree if the passed in courseNumber is less than currentNode's courseNumber
-            currentNode = currentNode->left;
-            nodesSearched++;
-        }
-        else { // Move to the right subtree if the passed in courseNumber is greater than currentNode's courseNumber
-            currentNode = currentNode->right;
-            nodesSearched++;
+const int MERGE_JOIN_MIN_COURSES = 1000000; // Catalogs at least this large no longer fit in cache, the only case where --bench has measured a merge join beating FindBatch
+
+void writeCsvField(string_view field) { // Writes a CSV field, quoting it if it contains a comma, quote, or line break
+    if (field.find_first_of(",\"\r\n") == string_view::npos) {
+        cout << field;
+        return;
+    }
+    cout << '"';
+    for (char character : field) {
+        if (character == '"') { // Quotes inside a quoted field are doubled
+            cout << '"';
         }
+        cout << character;
     }
-    CourseObject courseObject; // If the passed in courseNumber is not found, create and return an empty courseObject
-    return courseObject;
+    cout << '"';
 }
 
-void BinarySearchTree::addNode(BSTNode* node, CourseObject courseObject) { // Recursively add a courseObject to an accurate node in the BinarySearchTree
-    if (courseObject.courseNumber < node->courseObject.courseNumber) {
-        if (node->left == nullptr) { // If the left child is empty, create a new left child node with the passed in courseObject
-            node->left = new BSTNode(courseObject);
+void writeJsonString(string_view text) { // Writes text as a quoted JSON string, escaping the characters JSON does not allow as-is
+    cout << '"';
+    for (char character : text) {
+        if (character == '"' || character == '\\') {
+            cout << '\\' << character;
+        }
+        else if (static_cast<unsigned char>(character) < 0x20) { // Control characters are written as \u escapes
+            cout << "\\u00" << "0123456789abcdef"[(character >> 4) & 0xF] << "0123456789abcdef"[character & 0xF];
         }
         else {
-            addNode(node->left, courseObject); // Otherwise, recursively add the passed in courseObject to the left subtree
+            cout << character;
         }
     }
+    cout << '"';
+}
+
+void writeBatchResults(const vector<string_view>& queries, const vector<const CourseObject*>& results, bool json) { // Writes one record per query, in the order the queries were given
+    if (json) {
+        cout << "[\n";
+    }
     else {
-        if (node->right == nullptr) { // If the right child is empty, create a new right child node with the passed in courseObject
-            node->right = new BSTNode(courseObject);
+        cout << "query,found,courseNumber,name,prerequisites\n";
+    }
+    string prerequisiteField; // Reused for every CSV record, so joining the prerequisites does not allocate once it has grown
+    for (size_t i = 0; i < queries.size(); ++i) {
+        const CourseObject* course = results[i];
+        if (json) {
+            cout << "  {\"query\":";
+            writeJsonString(queries[i]);
+            cout << ",\"found\":" << (course != nullptr ? "true" : "false");
+            if (course != nullptr) {
+                cout << ",\"courseNumber\":";
+                writeJsonString(course->courseNumber);
+                cout << ",\"name\":";
+                writeJsonString(course->name);
+                cout << ",\"prerequisites\":[";
+                bool firstPrerequisite = true;
+                for (string_view prerequisite : course->prerequisites) {
+                    cout << (firstPrerequisite ? "" : ",");
+                    writeJsonString(prerequisite);
+                    firstPrerequisite = false;
+                }
+                cout << "]";
+            }
+            cout << (i + 1 < queries.size() ? "},\n" : "}\n");
         }
         else {
-            addNode(node->right, courseObject); // Otherwise, recursively add the passed in courseObject to the right subtree
+            writeCsvField(queries[i]);
+            if (course != nullptr) {
+                cout << ",true,";
+                writeCsvField(course->courseNumber);
+                cout << ",";
+                writeCsvField(course->name);
+                cout << ",";
+                prerequisiteField.clear();
+                for (string_view prerequisite : course->prerequisites) { // Prerequisites share one field, separated by semicolons, which is quoted like any other field
+                    if (!prerequisiteField.empty()) {
+                        prerequisiteField += ';';
+                    }
+                    prerequisiteField += prerequisite;
+                }
+                writeCsvField(prerequisiteField);
+                cout << "\n";
+            }
+            else {
+                cout << ",false,,,\n";
+            }
         }
     }
-}
-
-void BinarySearchTree::destroyTree(BSTNode* node) { // Recursively destroy the BinarySearchTree nodes
-    if (node != nullptr) {
-        destroyTree(node->left); // Recursively destroy the left subtree
-        destroyTree(node->right); // Recursively destroy the right subtree
-        delete node; // Delete the current node, which is the passed in root from the destructor
+    if (json) {
+        cout << "]\n";
     }
+    cout.flush();
 }
 
-BSTNode* BinarySearchTree::findMin(BSTNode* node) { // Find the node with the minimum value in the BinarySearchTree (included for modularity, but never explicitly called in this program)
-    while (node->left != nullptr) { // Traverse to the left child until the minimum node is found
-        node = node->left;
+int runBatchQueries(int argc, char* argv[]) { // Answers a list of course numbers against a catalog without the menu, returning the program's exit code
+    string catalogPath, queryPath = "-";
+    bool json = false, statistics = false;
+    int positional = 0;
+    for (int i = 2; i < argc; ++i) { // argv[1] is --batch
+        string argument = argv[i];
+        if (argument == "--format=json") {
+            json = true;
+        }
+        else if (argument == "--format=csv") {
+            json = false;
+        }
+        else if (argument == "--stats") {
+            statistics = true;
+        }
+        else if (positional == 0) {
+            catalogPath = argument;
+            positional++;
+        }
+        else if (positional == 1) {
+            queryPath = argument;
+            positional++;
+        }
+        else {
+            positional = -1; // Too many arguments
+            break;
+        }
     }
-    return node; // Return the minimum node
-}
-
-BSTNode* BinarySearchTree::removeNode(BSTNode* node, string courseNumber) { // Removes a node from the BinarySearchTree (included for modularity, but never explicitly called in this program)
-    if (node == nullptr) { // If the node is nullptr, return it as there is nothing to remove
-        return node;
+    if (positional < 1) {
+        cerr << "Usage: " << argv[0] << " --batch <catalog.csv> [<queries.txt> | -] [--format=csv | --format=json] [--stats]" << endl;
+        return 1;
+    }
+    streambuf* console = cout.rdbuf(cerr.rdbuf()); // Loading messages go to stderr so stdout only holds results
+    shared_ptr<const Catalog> catalog = loadCatalog(catalogPath);
+    cout.rdbuf(console);
+    if (catalog == nullptr) {
+        return 1;
     }
-    if (courseNumber < node->courseObject.courseNumber) {
-        node->left = removeNode(node->left, courseNumber); // Recursively traverse the left subtree
+    ifstream queryFile;
+    if (queryPath != "-") {
+        queryFile.open(queryPath);
+        if (!queryFile.is_open()) {
+            cerr << "Failed to open the file at \"" << queryPath << "\"." << endl;
+            return 1;
+        }
+    }
+    istream& queryInput = queryPath == "-" ? cin : queryFile;
+    string queryText; // Every query is kept in one buffer so the list below can view it
+    vector<size_t> queryEnds;
+    string line;
+    while (getline(queryInput, line)) {
+        string_view query = trimQuery(line);
+        if (!query.empty()) { // Blank lines are skipped
+            queryText.append(query.data(), query.size());
+            queryEnds.push_back(queryText.size());
+        }
     }
-    else if (courseNumber > node->courseObject.courseNumber) {
-        node->right = removeNode(node->right, courseNumber); // Recursively traverse the right subtree
+    vector<string_view> queries;
+    queries.reserve(queryEnds.size());
+    for (size_t i = 0, start = 0; i < queryEnds.size(); start = queryEnds[i++]) {
+        queries.push_back(string_view(queryText).substr(start, queryEnds[i] - start));
     }
-    else {
-        if (node->left == nullptr) { // If the node has no left child, replace it with the right child
-            BSTNode* temp = node->right;
-            delete node;
-            return temp;
+    vector<const CourseObject*> results(queries.size());
+    int courseCount = catalog->tree.Size();
+    if (courseCount >= MERGE_JOIN_MIN_COURSES && queries.size() >= static_cast<size_t>(courseCount)) { // A merge join walks up to the whole tree, so it only pays off with about one query per course; sort the keys so a single walk answers them all
+        vector<CourseKey> keys(queries.size());
+        vector<size_t> order(queries.size());
+        for (size_t i = 0; i < queries.size(); ++i) {
+            keys[i] = makeCourseKey(queries[i]);
+            order[i] = i;
         }
-        else if (node->right == nullptr) { // If the node has no right child, replace it with the left child
-            BSTNode* temp = node->left;
-            delete node;
-            return temp;
+        sort(order.begin(), order.end(), [&keys](size_t a, size_t b) { return compareCourseKeys(keys[a], keys[b]) < 0; });
+        vector<CourseKey> sortedKeys(queries.size());
+        for (size_t i = 0; i < order.size(); ++i) {
+            sortedKeys[i] = keys[order[i]];
         }
-        BSTNode* temp = findMin(node->right); // Find the minimum node in the right subtree
-        node->courseObject = temp->courseObject; // Replace the current node's courseObject with the minimum node's courseObject
-        node->right = removeNode(node->right, temp->courseObject.courseNumber); // Recursively remove the minimum node
+        vector<const CourseObject*> sortedResults(queries.size());
+        catalog->tree.MergeJoin(sortedKeys.data(), sortedKeys.size(), sortedResults.data());
+        for (size_t i = 0; i < order.size(); ++i) { // Put the answers back in the order the queries were given
+            results[order[i]] = sortedResults[i];
+        }
+    }
+    else {
+        catalog->index.FindBatch(queries.data(), queries.size(), results.data());
+    }
+    writeBatchResults(queries, results, json);
+    if (statistics) { // Statistics go to stderr so stdout only holds results
+        writeStatistics(cerr, catalog);
     }
-    return node; // Return the modified node to maintain the tree's structure
+    return 0;
 }
 
-int checkForFileFormatErrors(const CourseObject& newCourse, const vector<string>& availableCourses) { // Checks the CourseObject variables for errors, including prerequisites that are not found in available courses
-    if (newCourse.courseNumber.empty()) {
-        return 1; // Error code for blank course number
+int runSnapshot(int argc, char* argv[]) { // Loads a catalog and saves it as a snapshot without the menu, returning the program's exit code
+    if (argc != 4) {
+        cerr << "Usage: " << argv[0] << " --snapshot <catalog.csv> <catalog.snapshot>" << endl;
+        return 1;
     }
-    if (newCourse.name.empty()) {
-        return 2; // Error code for blank course name
+    shared_ptr<const Catalog> catalog = loadCatalog(argv[2]);
+    if (catalog == nullptr) {
+        return 1;
     }
-    for (const string& prerequisite : newCourse.prerequisites) {
-        bool foundPrerequisite = false;
-        for (const string& availableCourse : availableCourses) {
-            if (prerequisite == newCourse.courseNumber) {
-                return 3; // Error code for prerequisite equalling its own course number
-            }
-            if (prerequisite == availableCourse) {
-                foundPrerequisite = true;
-                break;
-            }
-        }
-        if (!foundPrerequisite) {
-            return 4; // Error code for missing prerequisite in available courses
-        }
+    if (!writeSnapshot(*catalog, argv[3])) {
+        cout << "Failed to write the file at \"" << argv[3] << "\".\n" << endl;
+        return 1;
     }
-    return 0; // No errors found
+    cout << "Saved " << catalog->tree.Size() << " courses to the snapshot at \"" << argv[3] << "\".\n" << endl;
+    return 0;
 }
 
-int parseCourseLine(const string& line, CourseObject& newCourse, const vector<string>& availableCourses) { // Parses each line from the input file to create CourseObjects and check for file format errors
-    size_t commaLoc = line.find(','); // Sets the location of the first found comma
-    if (commaLoc != string::npos) { // If the comma location is still in the provide line
-        newCourse.courseNumber = line.substr(0, commaLoc); // Sets the courseNumber to the string found before the first comma
-        string restOfLine = line.substr(commaLoc + 1); // Checks rest of the line
-        commaLoc = restOfLine.find(','); // Sets the location of the second found comma
-        if (commaLoc != string::npos) { // If the comma location is still in the provide line
-            newCourse.name = restOfLine.substr(0, commaLoc); // Sets the course name to the string found before the second comma
-            restOfLine = restOfLine.substr(commaLoc + 1); // Checks rest of the line
-            while (!restOfLine.empty()) { // If there are more commas in the line
-                commaLoc = restOfLine.find(','); // Sets the location of the next found comma
-                string prerequisite = restOfLine.substr(0, commaLoc); // Sets a prerequisite to the string found before the next comma
-                if (!prerequisite.empty() && prerequisite != " ") { // If the prerequisite is not empty or blank
-                    newCourse.prerequisites.push_back(prerequisite); // Adds the prerequisite to the CourseObjects prerequisite vector
-                }
-                restOfLine = restOfLine.substr(commaLoc + 1); // Checks rest of the line
-            }
+int runListing(int argc, char* argv[]) { // Writes one page of the course listing for a catalog without the menu, returning the program's exit code
+    string catalogPath, prefix, from, to;
+    bool hasPrefix = false, hasFrom = false, hasTo = false;
+    long long offset = 0, limit = -1; // By default the listing runs from the first course to the last
+    for (int i = 2; i < argc; ++i) { // argv[1] is --list
+        string argument = argv[i];
+        if (argument.compare(0, 9, "--offset=") == 0 && atoll(argument.c_str() + 9) >= 0) {
+            offset = atoll(argument.c_str() + 9);
+        }
+        else if (argument.compare(0, 8, "--limit=") == 0 && atoll(argument.c_str() + 8) >= 0) {
+            limit = atoll(argument.c_str() + 8);
+        }
+        else if (argument.compare(0, 9, "--prefix=") == 0) {
+            prefix = argument.substr(9);
+            hasPrefix = true;
+        }
+        else if (argument.compare(0, 7, "--from=") == 0) {
+            from = argument.substr(7);
+            hasFrom = true;
+        }
+        else if (argument.compare(0, 5, "--to=") == 0) {
+            to = argument.substr(5);
+            hasTo = true;
+        }
+        else if (catalogPath.empty() && argument.compare(0, 2, "--") != 0) {
+            catalogPath = argument;
         }
         else {
-            newCourse.name = restOfLine; // Rest of the line is the course name
+            catalogPath.clear();
+            break;
         }
     }
-    int error = checkForFileFormatErrors(newCourse, availableCourses); // Checks for errors in the new course object, including checking prerequisites against the available course list
-    if (error != 0) { // If an error is found
-        return error; // Return the error code
+    if (catalogPath.empty()) {
+        cerr << "Usage: " << argv[0] << " --list <catalog.csv> [--prefix=P] [--from=FIRST] [--to=LAST] [--offset=N] [--limit=N]" << endl;
+        return 1;
     }
-    return 0; // If no errors are found, the new course object is okay to be added to a node
-}
-
-void printHeader(const string& line) { // Displays the first line of the provided file as a header
-    istringstream lineStream(line); // Create a string stream to process the extracted header line from the input file
-    string item; // Variable to parse info from extracted header line
-    vector<string> items; // Variable to store those items
-    while (getline(lineStream, item, ',')) { // Extracts using commas as delimiters
-        items.push_back(item); // Appends the items vector
+    streambuf* console = cout.rdbuf(cerr.rdbuf()); // Loading messages go to stderr so stdout only holds the listing
+    shared_ptr<const Catalog> catalog = loadCatalog(catalogPath);
+    cout.rdbuf(console);
+    if (catalog == nullptr) {
+        return 1;
     }
-    cout << setw(10) << left << items[0] << "|" << setw(35) << left << items[1] << "|";
-    for (size_t i = 2; i < items.size(); ++i) {
-        cout << setw(14) << left << items[i] << "|";
+    int firstIndex = static_cast<int>(min<long long>(offset, catalog->tree.Size()));
+    TreeCursor cursor;
+    if (hasFrom || hasPrefix) { // The page starts offset courses past the later of the two lower bounds
+        string_view first = hasFrom && (!hasPrefix || compareCourseKeys(makeCourseKey(from), makeCourseKey(prefix)) > 0) ? string_view(from) : string_view(prefix);
+        cursor = catalog->tree.LowerBound(first);
+        cursor.Skip(firstIndex);
     }
-    cout << endl;
+    else { // Without a lower bound, the offset is already the page's position in the alphanumeric order
+        cursor = catalog->tree.CursorAt(firstIndex);
+    }
+    CourseKey last = makeCourseKey(to);
+    writeCourseListing(cout, *catalog, METRIC_RANGE, [&](auto appendCourse) {
+        for (long long written = 0; (limit < 0 || written < limit) && !cursor.AtEnd(); ++written) {
+            const CourseObject& courseObject = *cursor.Peek();
+            if ((hasTo && compareCourseKeys(makeCourseKey(courseObject.courseNumber), last) > 0) || (hasPrefix && !hasCoursePrefix(courseObject.courseNumber, prefix))) { // Both filters fail for every course after the first one they fail for, so even a page skipped past them ends here
+                break;
+            }
+            appendCourse(*cursor.Next());
+        }
+    });
+    return 0;
 }
 
-void displayAllCoursesAlphanumericOrder(BinarySearchTree* bst) {
-    ticks = clock(); // Starting clock ticks for timing how long this function takes
-    if (bst != nullptr) {
-        cout << "Courses Listed by Alphanumeric Order of Course Number:" << endl;
-        printHeader(fileHeader); // Calls for the header to be displayed
-        bst->InOrder(); // Calls the inOrder function in the BinarySearchTree class to display each CourseObject by ascending alphanumeric order based on course numbers
-        cout << endl;
-    }
-    else {
-        cout << "There is no data in the binary search tree.\n" << endl; // If the BinarySearchTree has yet to have data added to it
-        return;
-    }
-    ticks = clock() - ticks; // End of function clock ticks minus starting clock ticks
-    cout << "time: " << ticks << " clock ticks" << endl; // Display elapsed time results
-    cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
-    cout << "Displayed " << bst->Size() << " courses from the binary search tree.\n" << endl;
+const char* BENCHMARK_SHAPES[] = { "sorted", "reverse", "random", "chain", "fan" }; // Line orders and prerequisite patterns the benchmark can generate
+const char* BENCHMARK_DEFAULT_ROWS = "100,1000,10000,100000"; // Catalog sizes benchmarked unless --rows is given (sizes up to 10000000 may be requested)
+volatile size_t benchmarkSink; // Results of benchmarked work are stored here so the compiler cannot remove the work
+
+string syntheticCourseNumber(size_t id) { // Returns the course number for a synthetic course, four department letters then four digits, so ID order is alphanumeric order
+    char courseNumber[16];
+    size_t department = id / 10000;
+    snprintf(courseNumber, sizeof(courseNumber), "%c%c%c%c%04u", static_cast<char>('A' + department / 17576 % 26), static_cast<char>('A' + department / 676 % 26), static_cast<char>('A' + department / 26 % 26), static_cast<char>('A' + department % 26), static_cast<unsigned>(id % 10000));
+    return courseNumber;
 }
 
-void displaySpecificCourse(BinarySearchTree* bst) { // Displays information about a specific course based on user input
-    if (bst != nullptr) { // Check if the BinarySearchTree is not empty
-        string courseNumber, upperCourse;
-        cout << "Enter a course number to search for: ";
-        getline(cin, courseNumber);
-        ticks = clock(); // Starting clock ticks
-        upperCourse = courseNumber;
-        for (char& c : upperCourse) { // If a user enters any lowercase letters in their search, adjusts them to uppercase for accurate and easier searches
-            c = toupper(c);
-        }
-        cout << endl;
-        CourseObject foundCourse = bst->Search(upperCourse); // Calls the search function to find a fully uppercased course number
-        if (!foundCourse.courseNumber.empty()) { // If the search was successful, display associated course object information
-            cout << setw(15) << left << "Course Number: " << foundCourse.courseNumber << endl;
-            cout << "Name" << setw(11) << right << ": " << foundCourse.name << endl;
-            cout << setw(15) << left << "Prerequisites: ";
-            bool foundPrerequisites = false;
-            for (const string& prerequisite : foundCourse.prerequisites) {
-                if (foundPrerequisites == false) {
-                    cout << prerequisite;
-                    foundPrerequisites = true;
-                }
-                else {
-                    cout << ", " << prerequisite;
-                }
+bool writeSyntheticCatalog(const string& filePath, const string& shape, size_t rows, mt19937_64& random) { // Writes a catalog of rows courses in the given shape, returning false if the file could not be written
+    ofstream file(filePath, ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    vector<size_t> lineOrder(rows); // Course i is given the even ID 2 * i, so searches for odd IDs miss between existing courses
+    for (size_t i = 0; i < rows; ++i) {
+        lineOrder[i] = i;
+    }
+    if (shape == "reverse") {
+        reverse(lineOrder.begin(), lineOrder.end());
+    }
+    else if (shape == "random") {
+        shuffle(lineOrder.begin(), lineOrder.end(), random);
+    }
+    file << "Course Number,Course Name,Prerequisite,Prerequisite\n";
+    string line;
+    for (size_t course : lineOrder) {
+        line = syntheticCourseNumber(2 * course) + ",Synthetic Course " + to_string(course);
+        if (course > 0) { // Prerequisites always come earlier in ID order, so the catalog never has a cycle
+            if (shape == "chain") { // Every course requires the one before it, making one prerequisite chain as long as the catalog
+                line += "," + syntheticCourseNumber(2 * (course - 1));
             }
-            if (foundPrerequisites == false) {
-                cout << "None";
+            else if (shape == "fan") { // Every course requires the first course, which then unlocks the whole catalog
+                line += "," + syntheticCourseNumber(0);
+            }
+            else {
+                for (int i = static_cast<int>(random() % 3); i > 0; --i) {
+                    line += "," + syntheticCourseNumber(2 * (random() % course));
+                }
             }
-            cout << endl << endl;
-        }
-        else {
-            cout << "Course Number: \"" << courseNumber << "\" was not found\n" << endl; // Else display that the user entered course was not found
         }
-        ticks = clock() - ticks; // End of function clock ticks minus starting clock ticks
-        cout << "time: " << ticks << " clock ticks" << endl; // Display elapsed time results
-        cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
-        cout << "Searched through " << nodesSearched << " of " << bst->Size() << " courses in the binary search tree.\n" << endl;
-    }
-    else {
-        cout << "There is no data in the binary search tree.\n" << endl; // If the BinarySearchTree has yet to have data added to it
-        return;
+        line += '\n';
+        file << line;
     }
+    return static_cast<bool>(file);
 }
 
-vector<string> extractAllCourseNumbers(ifstream& inputFile) { // Function to create a list of all course numberss found in the input file based on the first element of each line
-    string currentLine;
-    getline(inputFile, currentLine); // Skip the first line which is a header, that is handles elsewhere for display
-    while (getline(inputFile, currentLine)) { // Extract the course numbers from the remaining lines of the input file
-        istringstream lineStream(currentLine); // Create a string stream to process the current line of the input file
-        string courseNumber;
-        getline(lineStream, courseNumber, ','); // Get the course number from the line until the first comma
-        allCourseNumbers.push_back(courseNumber); // Add the course number to the vector
+void reportBenchmark(const string& shape, size_t rows, const char* operation, const char* backend, vector<double>& samples) { // Writes one CSV line of nearest-rank percentiles for a set of samples
+    sort(samples.begin(), samples.end());
+    auto percentile = [&samples](double fraction) {
+        size_t rank = static_cast<size_t>(fraction * samples.size() + 0.999999);
+        return samples[min(samples.size(), max<size_t>(rank, 1)) - 1];
+    };
+    cout << shape << "," << rows << "," << operation << "," << backend << "," << samples.size() << fixed << setprecision(1)
+        << "," << samples.front() << "," << percentile(0.5) << "," << percentile(0.9) << "," << percentile(0.99) << "," << samples.back() << "\n" << defaultfloat;
+    cout.flush();
+}
+
+template <typename Work>
+double elapsedNanoseconds(Work work) { // Runs work once and returns how long it took by the monotonic clock
+    auto start = chrono::steady_clock::now();
+    work();
+    return chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+}
+
+void benchmarkLookups(const string& shape, size_t rows, const char* operation, const Catalog& catalog, const vector<string>& queryText, int repetitions) { // Times every lookup backend on the same queries, reporting nanoseconds per query
+    vector<string_view> queries(queryText.begin(), queryText.end());
+    vector<const CourseObject*> results(queries.size());
+    vector<double> treeSamples, indexSamples, batchSamples, mergeSamples;
+    for (int repetition = 0; repetition < repetitions; ++repetition) {
+        size_t found = 0;
+        treeSamples.push_back(elapsedNanoseconds([&]() {
+            for (string_view query : queries) {
+                found += catalog.tree.Search(query) != nullptr;
+            }
+        }) / queries.size());
+        indexSamples.push_back(elapsedNanoseconds([&]() {
+            for (string_view query : queries) {
+                found += catalog.index.Find(query) != nullptr;
+            }
+        }) / queries.size());
+        batchSamples.push_back(elapsedNanoseconds([&]() {
+            catalog.index.FindBatch(queries.data(), queries.size(), results.data());
+            found += results[0] != nullptr;
+        }) / queries.size());
+        mergeSamples.push_back(elapsedNanoseconds([&]() { // Includes sorting the keys, as batch mode must
+            vector<CourseKey> keys(queries.size());
+            for (size_t i = 0; i < queries.size(); ++i) {
+                keys[i] = makeCourseKey(queries[i]);
+            }
+            sort(keys.begin(), keys.end(), [](const CourseKey& first, const CourseKey& second) { return compareCourseKeys(first, second) < 0; });
+            catalog.tree.MergeJoin(keys.data(), keys.size(), results.data());
+            found += results[0] != nullptr;
+        }) / queries.size());
+        benchmarkSink = found;
     }
-    return allCourseNumbers; // Return the vector containing all extracted course numbers to be used as a prerequisite comparison
+    reportBenchmark(shape, rows, operation, "tree", treeSamples);
+    reportBenchmark(shape, rows, operation, "index", indexSamples);
+    reportBenchmark(shape, rows, operation, "index-batch", batchSamples);
+    reportBenchmark(shape, rows, operation, "merge-join", mergeSamples);
 }
 
-CourseObject createNewCourseObject(const string& line, const vector<string>& availableCourses, int lineCount) { // Creates a new CourseObject based on the provided line and available courses
-    CourseObject newCourse; // Creates a new CourseObject to hold the parsed data
-    int error = parseCourseLine(line, newCourse, availableCourses); // Parses the provided line and stores the results in the new CourseObject
-    if (error != 0) { // If an error occurred during parsing
-        if (error == 1) {
-            cout << "Missing course number on line " << lineCount << " of the provided file.\n" << endl;
+int runBenchmarks(int argc, char* argv[]) { // Generates synthetic catalogs and times loading, searching, traversal, and teardown, writing CSV results to stdout
+    string rowList = BENCHMARK_DEFAULT_ROWS, shapeList, directory = ".";
+    int repetitions = 15;
+    size_t queryCount = 1000;
+    for (int i = 2; i < argc; ++i) { // argv[1] is --bench
+        string argument = argv[i];
+        size_t equals = argument.find('=');
+        string option = argument.substr(0, equals), value = equals == string::npos ? "" : argument.substr(equals + 1);
+        if (option == "--rows" && !value.empty()) {
+            rowList = value;
+        }
+        else if (option == "--shapes" && !value.empty()) {
+            shapeList = value;
         }
-        if (error == 2) {
-            cout << "Missing course name on line " << lineCount << " of the provided file.\n" << endl;
+        else if (option == "--repetitions" && atoi(value.c_str()) > 0) {
+            repetitions = atoi(value.c_str());
         }
-        if (error == 3) {
-            cout << "The course on line " << lineCount << " has itself as a prerequisite.\n" << endl;
+        else if (option == "--queries" && atoi(value.c_str()) > 0) {
+            queryCount = static_cast<size_t>(atoi(value.c_str()));
         }
-        if (error == 4) {
-            cout << "There was no available course matching the prerequisite\nfound on line " << lineCount << " of the provided file.\n" << endl;
+        else if (option == "--dir" && !value.empty()) {
+            directory = value;
         }
-        if (error != 1 && error != 2 && error != 3) {
-            cout << "An unknown error was found on line " << lineCount << " of the provided file." << endl; // Should not be called in the scope of this program
+        else {
+            cerr << "Usage: " << argv[0] << " --bench [--rows=100,1000,...] [--shapes=sorted,reverse,random,chain,fan] [--repetitions=15] [--queries=1000] [--dir=.]" << endl;
+            return 1;
         }
-        delete bst; // Delete BinarySearchTree and free its memory
-        bst = nullptr;
-        return newCourse; // Returns an empty course object because an error occurred
     }
-    return newCourse; // Returns a completed course object
-}
-
-void processRequestedFile(string filePath) {
-    ticks = clock(); // Starting clock ticks
-    ifstream inputFile(filePath); // Tries to open the file at the given filePath
-    if (inputFile.is_open()) { // If the file at the given filePath was successfully opened
-        cout << "\nSuccessfully opened the file at \"" << filePath << "\".\n" << endl;
-        allCourseNumbers = extractAllCourseNumbers(inputFile); // Make a list of every course number, which is the first element of each line (i.e., in a CSV before the first comma on each line)
-        inputFile.close(); // Close the file to reset the ifstream, otherwise following calls to the input file will read start from its end, which is empty
-        inputFile.open(filePath); // Reopens the input file so it may be used again
-        bst = new BinarySearchTree(); // Initializes a new BinarySearchTree to hold nodes with stored course objects
-        string currentLine;
-        getline(inputFile, fileHeader); // This assumes the first line of the CSV is a descriptive header, and does not include it in the array
-        int lineCount = 2; // Excludes the header so that errors may be pinpointed to specific lines of the input file
-        while (getline(inputFile, currentLine)) { // Read and process each line in the file
-            CourseObject newCourse = createNewCourseObject(currentLine, allCourseNumbers, lineCount); // Create new course objects to be stored in BinarySearchTree nodes
-            if (bst != nullptr) { // If an error is found and the BinarySearchTree is deleted, a new node is not created and this function ends, returning the user to the main menu with an error message
-                bst->Insert(newCourse);
-                lineCount++; // Increments a line count that can pinpoint where in the input file an error may be found
+    vector<size_t> rowCounts;
+    for (size_t start = 0; start < rowList.size(); ) {
+        size_t end = min(rowList.find(',', start), rowList.size());
+        rowCounts.push_back(static_cast<size_t>(atoll(rowList.substr(start, end - start).c_str())));
+        start = end + 1;
+    }
+    vector<string> shapes;
+    for (const char* shape : BENCHMARK_SHAPES) {
+        if (shapeList.empty() || ("," + shapeList + ",").find("," + string(shape) + ",") != string::npos) {
+            shapes.push_back(shape);
+        }
+    }
+    cout << "shape,rows,operation,backend,repetitions,min_ns,p50_ns,p90_ns,p99_ns,max_ns\n"; // Searches are timed per query, everything else per catalog
+    mt19937_64 random(20230101); // A fixed seed, so every run benchmarks the same catalogs and queries
+    for (const string& shape : shapes) {
+        for (size_t rows : rowCounts) {
+            if (rows == 0) {
+                continue;
             }
-            else {
-                return; // Exits the function as an error was found in the file format
+            string filePath = directory + "/bench_" + shape + "_" + to_string(rows) + ".csv";
+            if (!writeSyntheticCatalog(filePath, shape, rows, random)) {
+                cerr << "Failed to write the file at \"" << filePath << "\"." << endl;
+                return 1;
+            }
+            vector<double> loadSamples, traversalSamples, teardownSamples;
+            shared_ptr<const Catalog> catalog;
+            for (int repetition = 0; repetition < repetitions; ++repetition) {
+                streambuf* console = cout.rdbuf(nullptr); // Loading messages are discarded so console output is not timed
+                loadSamples.push_back(elapsedNanoseconds([&]() { catalog = loadCatalog(filePath); }));
+                cout.rdbuf(console);
+                if (catalog == nullptr) {
+                    cerr << "Failed to load the generated file at \"" << filePath << "\"." << endl;
+                    return 1;
+                }
+                traversalSamples.push_back(elapsedNanoseconds([&]() {
+                    size_t nameLength = 0;
+                    catalog->tree.ForEachInOrder([&nameLength](const CourseObject& courseObject) { nameLength += courseObject.name.size(); });
+                    benchmarkSink = nameLength;
+                }));
+                if (repetition + 1 < repetitions) { // The last catalog is kept for the searches below and torn down after them
+                    teardownSamples.push_back(elapsedNanoseconds([&]() { catalog.reset(); }));
+                }
             }
+            vector<string> hits(queryCount), misses(queryCount);
+            for (size_t i = 0; i < queryCount; ++i) {
+                hits[i] = syntheticCourseNumber(2 * (random() % rows));
+                misses[i] = syntheticCourseNumber(2 * (random() % rows) + 1); // Odd IDs fall between existing courses
+            }
+            reportBenchmark(shape, rows, "load", "tree", loadSamples);
+            benchmarkLookups(shape, rows, "search-hit", *catalog, hits, repetitions);
+            benchmarkLookups(shape, rows, "search-miss", *catalog, misses, repetitions);
+            reportBenchmark(shape, rows, "traversal", "tree", traversalSamples);
+            teardownSamples.push_back(elapsedNanoseconds([&]() { catalog.reset(); }));
+            reportBenchmark(shape, rows, "teardown", "tree", teardownSamples);
+            remove(filePath.c_str());
         }
-        inputFile.close(); // Closes the input file
-        ticks = clock() - ticks; // End of function clock ticks minus starting clock ticks
-        cout << "time: " << ticks << " clock ticks" << endl; // Display elapsed time results
-        cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
-        cout << "Loaded " << bst->Size() << " courses into the binary search tree.\n" << endl;
-    }
-    else { // If the file at the given filePath was NOT successfully opened
-        cout << "\nFailed to open the file at \"" << filePath << "\".\n" << endl;
     }
+    return 0;
 }
 
-int main() { // The main() function responsible for running the program
+const int EXIT_CHOICE = 8; // The menu selection that exits the program
+
+int main(int argc, char* argv[]) { // The main() function responsible for running the program
+    if (argc > 1 && string(argv[1]) == "--batch") { // Batch mode answers a list of course numbers and exits without showing the menu
+        return runBatchQueries(argc, argv);
+    }
+    if (argc > 1 && string(argv[1]) == "--snapshot") { // Snapshot mode saves a catalog in a form that loads without parsing, and exits without showing the menu
+        return runSnapshot(argc, argv);
+    }
+    if (argc > 1 && string(argv[1]) == "--list") { // List mode writes a page of the course listing and exits without showing the menu
+        return runListing(argc, argv);
+    }
+    if (argc > 1 && string(argv[1]) == "--bench") { // Benchmark mode times synthetic catalogs and exits without showing the menu
+        return runBenchmarks(argc, argv);
+    }
     string filePath, courseNumber, confirmation, tempChoice;
     int choice = 0, choice2;
     cout << "Welcome to ABC University's Computer Science\nDepartment's Advising Assistance Software!\n" << endl;
-    while (choice != 4) { // Displays a menu as long as the user does not choose to exit
+    while (choice != EXIT_CHOICE) { // Displays a menu as long as the user does not choose to exit
         cout << "Main Menu:" << endl;
         cout << "  1. Load Course Information into a Binary Search Tree" << endl;
         cout << "  2. Print Course List in Alphanumeric Order" << endl;
         cout << "  3. Print Specific Course Information" << endl;
-        cout << "  4. Exit the Program" << endl;
+        cout << "  4. Print a Course's Prerequisite Plan" << endl;
+        cout << "  5. Print Courses by Prefix or Range" << endl;
+        cout << "  6. Apply Course Changes from a Delta File" << endl;
+        cout << "  7. Print Operation Statistics" << endl;
+        cout << "  8. Exit the Program" << endl;
         cout << "Please enter a menu selection: ";
-        if (!(getline(cin, tempChoice)) || (tempChoice != "1" && tempChoice != "2" && tempChoice != "3" && tempChoice != "4")) { // Check to see if the user entered a valid choice, and if not sets the choice to 0
+        if (!(getline(cin, tempChoice)) || tempChoice.size() != 1 || tempChoice[0] < '1' || tempChoice[0] > '0' + EXIT_CHOICE) { // Check to see if the user entered a valid choice, and if not sets the choice to 0
             cout << endl << "\"" << tempChoice << "\" is an invalid menu selection." << endl;
             cout << "Please enter a valid menu selection." << endl;
-            cout << "(i.e., '1', '2', '3', or '4'.)\n" << endl;
+            cout << "(i.e., '1' through '" << EXIT_CHOICE << "'.)\n" << endl;
             choice = 0; // Sets choice to 0 to repeat the menu options for the while loop at the switch(0)
         }
         else {
@@ -442,14 +3247,28 @@ int main() { // The main() function responsible for running the program
             processRequestedFile(filePath);
             break;
         case 2:
-            displayAllCoursesAlphanumericOrder(bst);
+            displayAllCoursesAlphanumericOrder(currentCatalog());
             break;
         case 3:
-            displaySpecificCourse(bst);
+            displaySpecificCourse(currentCatalog());
+            break;
+        case 4:
+            displayCoursePlan(currentCatalog());
+            break;
+        case 5:
+            displayCourseRange(currentCatalog());
+            break;
+        case 6:
+            cout << "Please provide a file path for the delta file you wish to apply.\nEach line after the header is ADD or MODIFY followed by a course line, or DELETE followed by a course number.\nFile Path: ";
+            getline(cin, filePath);
+            processDeltaFile(filePath);
+            break;
+        case 7:
+            displayStatistics();
             break;
         }
     }
-    delete bst; // Delete BinarySearchTree and free its memory    
+    publishCatalog(nullptr); // Frees the catalog once nothing else is reading it
     cout << "Thank you for using the ABC University's Computer\nScience Department's Advising Assistance Software!" << endl;
     return 0;
 }
\ No newline at end of file